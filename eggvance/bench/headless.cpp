@@ -0,0 +1,41 @@
+#include "frontend/audiocontext.h"
+#include "frontend/inputcontext.h"
+#include "frontend/videocontext.h"
+
+// The benchmark links the core without the frontend. These stand in for
+// the parts of the contexts which the core uses.
+
+VideoContext::~VideoContext()
+{
+
+}
+
+void VideoContext::renderFrame()
+{
+
+}
+
+VideoContext::Scanline& VideoContext::scanline(uint line)
+{
+    return framebuffer[line];
+}
+
+AudioContext::~AudioContext()
+{
+
+}
+
+void AudioContext::write(Samples samples)
+{
+
+}
+
+InputContext::~InputContext()
+{
+
+}
+
+uint InputContext::state() const
+{
+    return 0;
+}
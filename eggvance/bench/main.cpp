@@ -0,0 +1,294 @@
+#include <chrono>
+#include <shell/fmt.h>
+#include <shell/options.h>
+#include <shell/utility.h>
+
+#include "apu/apu.h"
+#include "arm/arm.h"
+#include "base/config.h"
+#include "dma/dma.h"
+#include "gamepak/gamepak.h"
+#include "keypad/keypad.h"
+#include "ppu/color.h"
+#include "ppu/ppu.h"
+#include "scheduler/scheduler.h"
+#include "sio/sio.h"
+#include "timer/timer.h"
+
+using Clock = std::chrono::steady_clock;
+
+inline constexpr auto kFrameCycles = 4 * (kScreenW + 68) * (kScreenH + 68);
+
+// Busy loops which count their iterations in r0. Each one stores to and
+// loads from IWRAM and mixes shifts, flag setting and conditional code.
+inline constexpr u32 kArmLoop[] =
+{
+    0xE3A0'0000,  // mov    r0, 0
+    0xE3A0'1001,  // mov    r1, 1
+    0xE3A0'2403,  // mov    r2, 0x3000000
+    0xE081'3101,  // loop:  add r3, r1, r1, lsl 2
+    0xE043'4001,  // sub    r4, r3, r1
+    0xE024'5003,  // eor    r5, r4, r3
+    0xE185'6000,  // orr    r6, r5, r0
+    0xE206'70FF,  // and    r7, r6, 0xFF
+    0xE582'7004,  // str    r7, [r2, 4]
+    0xE592'8004,  // ldr    r8, [r2, 4]
+    0xE158'0007,  // cmp    r8, r7
+    0x0280'0001,  // addeq  r0, r0, 1
+    0xE1B0'90A3,  // movs   r9, r3, lsr 1
+    0xE0A9'A001,  // adc    r10, r9, r1
+    0xEAFF'FFF3   // b      loop
+};
+
+inline constexpr u16 kThumbLoop[] =
+{
+    0x0001,  // add   r0, pc, 1 (ARM)
+    0xE28F,
+    0xFF10,  // bx    r0 (ARM)
+    0xE12F,
+    0x2000,  // mov   r0, 0
+    0x2101,  // mov   r1, 1
+    0x2203,  // mov   r2, 3
+    0x0612,  // lsl   r2, r2, 24
+    0x184B,  // loop: add r3, r1, r1
+    0x009C,  // lsl   r4, r3, 2
+    0x1A65,  // sub   r5, r4, r1
+    0x405D,  // eor   r5, r3
+    0x430D,  // orr   r5, r1
+    0x6055,  // str   r5, [r2, 4]
+    0x6856,  // ldr   r6, [r2, 4]
+    0x42AE,  // cmp   r6, r5
+    0xD1F6,  // bne   loop
+    0x3001,  // add   r0, 1
+    0xE7F4   // b     loop
+};
+
+// Arms four timers, two of them cascading, which drive both sound FIFOs
+// through DMA. Runs the ARM loop afterwards.
+inline constexpr u32 kEventSetup[] =
+{
+    0xE3A0'1301,  // mov    r1, 0x4000000
+    0xE3A0'0080,  // mov    r0, 0x80
+    0xE1C1'08B4,  // strh   r0, [r1, 0x84]   SOUNDCNT_X
+    0xE3A0'0C73,  // mov    r0, 0x7300
+    0xE380'000C,  // orr    r0, r0, 0xC
+    0xE1C1'08B2,  // strh   r0, [r1, 0x82]   SOUNDCNT_H
+    0xE3A0'0302,  // mov    r0, 0x8000000
+    0xE581'00BC,  // str    r0, [r1, 0xBC]   DMA1SAD
+    0xE581'00C8,  // str    r0, [r1, 0xC8]   DMA2SAD
+    0xE381'00A0,  // orr    r0, r1, 0xA0
+    0xE581'00C0,  // str    r0, [r1, 0xC0]   DMA1DAD
+    0xE381'00A4,  // orr    r0, r1, 0xA4
+    0xE581'00CC,  // str    r0, [r1, 0xCC]   DMA2DAD
+    0xE3A0'0CB6,  // mov    r0, 0xB600
+    0xE380'0040,  // orr    r0, r0, 0x40
+    0xE1C1'0CB6,  // strh   r0, [r1, 0xC6]   DMA1CNT_H
+    0xE1C1'0DB2,  // strh   r0, [r1, 0xD2]   DMA2CNT_H
+    0xE3A0'0502,  // mov    r0, 0x800000
+    0xE380'0CFF,  // orr    r0, r0, 0xFF00
+    0xE581'0100,  // str    r0, [r1, 0x100]  TM0CNT
+    0xE3A0'0502,  // mov    r0, 0x800000
+    0xE380'0CFE,  // orr    r0, r0, 0xFE00
+    0xE581'0104,  // str    r0, [r1, 0x104]  TM1CNT
+    0xE3A0'0721,  // mov    r0, 0x840000
+    0xE380'0CFF,  // orr    r0, r0, 0xFF00
+    0xE380'00F0,  // orr    r0, r0, 0xF0
+    0xE581'0108,  // str    r0, [r1, 0x108]  TM2CNT
+    0xE581'010C   // str    r0, [r1, 0x10C]  TM3CNT
+};
+
+// Counts vblanks in r2 by polling VCOUNT. Both loops only read memory
+// which changes through scheduler events, so they can be skipped. The
+// second one exits forward and closes with an unconditional branch.
+inline constexpr u16 kIdleLoop[] =
+{
+    0x0001,  // add   r0, pc, 1 (ARM)
+    0xE28F,
+    0xFF10,  // bx    r0 (ARM)
+    0xE12F,
+    0x2104,  // mov   r1, 4
+    0x0609,  // lsl   r1, r1, 24
+    0x2200,  // mov   r2, 0
+    0x88C8,  // line: ldrh r0, [r1, 6]
+    0x28A0,  // cmp   r0, 160
+    0xD0FC,  // beq   line
+    0x88C8,  // wait: ldrh r0, [r1, 6]
+    0x28A0,  // cmp   r0, 160
+    0xD000,  // beq   vblank
+    0xE7FB,  // b     wait
+    0x3201,  // vblank: add r2, 1
+    0xE7F6   // b     line
+};
+
+inline constexpr uint kArmLoopLength   = 12;
+inline constexpr uint kThumbLoopLength = 11;
+
+// Places the programs one after another
+template<typename... Programs>
+void loadProgram(const Programs&... programs)
+{
+    constexpr u32 kEntry = 0x100;
+
+    auto& rom = gamepak.rom;
+    rom.assign(0x400, 0);
+    rom.mask = Rom::kMaxSize;
+
+    // The header branches over itself to the program
+    shell::write(rom.data(), 0, static_cast<u32>(0xEA00'0000 | (kEntry - 8) / 4));
+
+    u32 addr = kEntry;
+    auto write = [&](const auto& program)
+    {
+        for (auto instr : program)
+        {
+            shell::write(rom.data(), addr, instr);
+            addr += sizeof(instr);
+        }
+    };
+    (write(programs), ...);
+
+    gamepak.gpio = std::make_shared<Gpio>();
+    gamepak.save = std::make_shared<Save>();
+}
+
+void reset()
+{
+    gamepak.save->reset();
+    gamepak.gpio->reset();
+
+    shell::reconstruct(apu);
+    shell::reconstruct(arm);
+    shell::reconstruct(dma);
+    shell::reconstruct(ppu);
+    shell::reconstruct(keypad);
+    shell::reconstruct(sio);
+    shell::reconstruct(scheduler);
+    shell::reconstruct(timer);
+
+    apu.init();
+    arm.init();
+    ppu.init();
+}
+
+double runFrames(uint frames)
+{
+    const auto begin = Clock::now();
+
+    for (uint frame = 0; frame < frames; ++frame)
+    {
+        keypad.update();
+        arm.run(kFrameCycles);
+        ppu.sync();
+    }
+
+    return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+void print(const std::string& name, double value, const std::string& unit)
+{
+    fmt::print("{:<14}{:>12.2f} {}\n", name, value, unit);
+}
+
+int main(int argc, char* argv[])
+{
+    using namespace shell;
+
+    Options options("eggvance-bench");
+    options.add({ "workload",    "arm, thumb, events, idle or rom"             }, Options::value<std::string>()->positional());
+    options.add({ "rom",         "ROM file for the rom workload"               }, Options::value<fs::path>()->positional()->optional());
+    options.add({ "-f,--frames", "emulated frames", "count"                    }, Options::value<uint>()->optional());
+    options.add({ "-e,--engine", "interpreter, block or recompiler", "name"    }, Options::value<std::string>()->optional());
+
+    OptionsResult result;
+    try
+    {
+        result = options.parse(argc, argv);
+    }
+    catch (const ParseError& error)
+    {
+        fmt::print("Cannot parse command line: {}\n", error.what());
+
+        return 1;
+    }
+
+    const auto workload = result.find<std::string>("workload").value_or("");
+    const auto frames   = result.find<uint>("--frames").value_or(600);
+    const auto engine   = result.find<std::string>("--engine").value_or("interpreter");
+
+    if (engine != "interpreter" && engine != "block" && engine != "recompiler")
+    {
+        fmt::print("Unknown engine: {}\n", engine);
+
+        return 1;
+    }
+
+    config.bios_skip      = true;
+    config.bios_hle       = false;
+    config.block_cache    = engine != "interpreter";
+    config.recompiler     = engine == "recompiler";
+    config.render_thread  = false;
+    config.video_layers   = 0b11111;
+    config.audio_channels = 0b111111;
+
+    Bios::init(config.bios_file);
+    Color::init(true);
+
+    uint loop_length = 0;
+    if (workload == "arm")
+    {
+        loadProgram(kArmLoop);
+        loop_length = kArmLoopLength;
+    }
+    else if (workload == "thumb")
+    {
+        loadProgram(kThumbLoop);
+        loop_length = kThumbLoopLength;
+    }
+    else if (workload == "events")
+    {
+        loadProgram(kEventSetup, kArmLoop);
+        loop_length = kArmLoopLength;
+    }
+    else if (workload == "idle")
+    {
+        loadProgram(kIdleLoop);
+    }
+    else if (workload == "rom")
+    {
+        const auto rom = result.find<fs::path>("rom");
+        if (rom)
+            gamepak.load(*rom, fs::path());
+
+        if (gamepak.rom.empty())
+        {
+            fmt::print("Cannot load ROM\n");
+
+            return 1;
+        }
+    }
+    else
+    {
+        fmt::print("Unknown workload: {}\n", workload);
+
+        return 1;
+    }
+
+    reset();
+
+    double seconds = runFrames(frames);
+
+    print("time", seconds, "s");
+    print("speed", frames / seconds, "fps");
+
+    if (loop_length)
+    {
+        double instructions = static_cast<double>(arm.regs[0]) * loop_length;
+
+        print("instructions", instructions / seconds / 1e6, "M/s");
+    }
+
+    if (workload == "idle")
+        print("vblanks", arm.regs[2], "");
+
+    return 0;
+}
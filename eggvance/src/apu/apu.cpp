@@ -5,6 +5,7 @@
 #include "dma/dma.h"
 #include "frontend/audiocontext.h"
 #include "scheduler/scheduler.h"
+#include "timer/timer.h"
 
 inline constexpr auto kSampleCycles   = kCpuFrequency / kSampleRate;
 inline constexpr auto kSequenceCycles = kCpuFrequency / 512;
@@ -13,7 +14,7 @@ Apu::Apu()
 {
     events.sequence = [this](u64 late)
     {
-        sequence<0>(late);
+        sequence(late);
     };
 
     events.sample = [this](u64 late)
@@ -28,6 +29,17 @@ void Apu::init()
     scheduler.insert(events.sequence, kSequenceCycles);
 }
 
+void Apu::push(uint index, u8 byte)
+{
+    auto& fifo    = fifos[index];
+    auto& channel = timer.channels[fifo.timer];
+
+    // Consume batched overflows before the FIFO grows
+    channel.sync();
+    fifo.write(byte);
+    channel.schedule();
+}
+
 void Apu::onOverflow(uint timer, uint ticks)
 {
     if (!control.enabled)
@@ -40,28 +52,37 @@ void Apu::onOverflow(uint timer, uint ticks)
         if (fifo.timer != timer)
             continue;
 
-        for (uint x = 0; x < ticks; ++x)
-        {
-            fifo.tick();
-        }
+        fifo.tick(ticks);
 
         if (fifo.size() <= 16)
             dma.broadcast(event);
     }
 }
 
-template<uint kStep>
-void Apu::sequence(u64 late)
+u64 Apu::pendingOverflows(uint timer) const
 {
-    static_assert(!(kStep == 1 || kStep == 3 || kStep == 5));
+    if (!control.enabled)
+        return 0;
+
+    u64 overflows = 0;
 
-    switch (kStep)
+    for (const auto& fifo : fifos)
     {
-    case 1:
-    case 3:
-    case 5:
-        break;
+        if (fifo.timer != timer)
+            continue;
+
+        // Overflows until the FIFO requests a refill
+        u64 refill = fifo.size() > 16 ? fifo.size() - 16 : 1;
+
+        overflows = overflows ? std::min(overflows, refill) : refill;
+    }
+    return overflows;
+}
 
+void Apu::sequence(u64 late)
+{
+    switch (step)
+    {
     case 2:
     case 6:
         square1.tickSweep();
@@ -86,22 +107,12 @@ void Apu::sequence(u64 late)
         break;
     }
 
-    if constexpr (kStep == 0 || kStep == 2 || kStep == 4)
-    {
-        events.sequence = [this](u64 late)
-        {
-            sequence<(kStep + 2) % 8>(late);
-        };
-        scheduler.insert(events.sequence, 2 * kSequenceCycles - late);
-    }
-    else
-    {
-        events.sequence = [this](u64 late)
-        {
-            sequence<(kStep + 1) % 8>(late);
-        };
-        scheduler.insert(events.sequence, 1 * kSequenceCycles - late);
-    }
+    // Steps 1, 3 and 5 do nothing and are skipped
+    uint steps = step == 0 || step == 2 || step == 4 ? 2 : 1;
+
+    step = (step + steps) % 8;
+
+    scheduler.insert(events.sequence, steps * kSequenceCycles - late);
 }
 
 void Apu::sample(u64 late)
@@ -110,6 +121,9 @@ void Apu::sample(u64 late)
 
     if (control.enabled)
     {
+        for (const auto& fifo : fifos)
+            timer.channels[fifo.timer].sync();
+
         Channel* channels[4] = { &square1, &square2, &wave, &noise };
 
         for (auto [index, channel] : shell::enumerate(channels))
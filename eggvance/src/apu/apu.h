@@ -14,7 +14,9 @@ class Apu
     Apu();
 
     void init();
+    void push(uint index, u8 byte);
     void onOverflow(uint timer, uint ticks);
+    u64 pendingOverflows(uint timer) const;
 
     Square1 square1;
     Square2 square2;
@@ -25,15 +27,16 @@ class Apu
     SoundBias bias;
 
 private:
-    template<uint kStep>
     void sequence(u64 late);
     void sample(u64 late);
 
     struct Events
     {
-        Event sequence;
-        Event sample;
+        Event sequence{"apu.sequence"};
+        Event sample{"apu.sample"};
     } events;
+
+    uint step = 0;
 };
 
 inline Apu apu;
@@ -1,6 +1,14 @@
 #include "fifo.h"
 
-void Fifo::tick()
+void Fifo::tick(uint ticks)
 {
-    sample = size() ? read() : 0;
+    if (ticks > size())
+    {
+        clear();
+        sample = 0;
+        return;
+    }
+
+    while (ticks--)
+        sample = read();
 }
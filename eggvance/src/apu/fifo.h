@@ -7,7 +7,7 @@
 class Fifo : public shell::RingBuffer<s8, 32>
 {
 public:
-    void tick();
+    void tick(uint ticks);
 
     s16  sample    = 0;
     uint volume    = 0;
@@ -2,6 +2,7 @@
 
 #include "apu.h"
 #include "base/config.h"
+#include "timer/timer.h"
 
 SoundControl::SoundControl()
 {
@@ -48,6 +49,9 @@ void SoundControl::write(uint index, u8 byte)
         break;
 
     case 3:
+        timer.channels[0].sync();
+        timer.channels[1].sync();
+
         apu.fifos[0].enabled_r = bit::seq<0, 1>(byte);
         apu.fifos[0].enabled_l = bit::seq<1, 1>(byte);
         apu.fifos[0].timer     = bit::seq<2, 1>(byte);
@@ -57,10 +61,19 @@ void SoundControl::write(uint index, u8 byte)
         
         if (byte & (1 << 3)) apu.fifos[0].clear();
         if (byte & (1 << 7)) apu.fifos[1].clear();
+
+        timer.channels[0].schedule();
+        timer.channels[1].schedule();
         break;
 
     case 4:
+        timer.channels[0].sync();
+        timer.channels[1].sync();
+
         enabled = bit::seq<7, 1>(byte);
+
+        timer.channels[0].schedule();
+        timer.channels[1].schedule();
         break;
     }
 }
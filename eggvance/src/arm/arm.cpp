@@ -1,7 +1,10 @@
 #include "arm.h"
 
 #include "decode.h"
+#include "idleloop.h"
+#include "base/config.h"
 #include "dma/dma.h"
+#include "gamepak/gamepak.h"
 #include "scheduler/scheduler.h"
 #include "timer/timer.h"
 
@@ -15,6 +18,9 @@ Arm::Arm()
 
 void Arm::init()
 {
+    blocks.clear();
+    recompiler.clear();
+    initPages();
     flushWord();
     pc += 4;
 }
@@ -57,6 +63,9 @@ void Arm::dispatch()
             }
             else
             {
+                if (config.block_cache && dispatchBlock<kState>())
+                    continue;
+
                 if (kState & State::Thumb)
                 {
                     u16 instr = pipe[0];
@@ -65,7 +74,7 @@ void Arm::dispatch()
                     pipe[1] = readHalf(pc, pipe.access);
                     pipe.access = Access::Sequential;
 
-                    std::invoke(instr_thumb[hashThumb(instr)], this, instr);
+                    instr_thumb[hashThumb(instr)](*this, instr);
                 }
                 else
                 {
@@ -77,7 +86,7 @@ void Arm::dispatch()
 
                     if (cpsr.check(instr >> 28))
                     {
-                        std::invoke(instr_arm[hashArm(instr)], this, instr);
+                        instr_arm[hashArm(instr)](*this, instr);
                     }
                 }
             }
@@ -86,6 +95,174 @@ void Arm::dispatch()
     }
 }
 
+template<uint kState>
+bool Arm::dispatchBlock()
+{
+    using Opcode = std::conditional_t<kState & State::Thumb, u16, u32>;
+
+    constexpr uint kSize = sizeof(Opcode);
+
+    u32 addr = pc - 2 * kSize;
+    if (!BlockCache::isCacheable(addr))
+        return false;
+
+    Block<Opcode>* block = blocks.find<Opcode>(addr);
+    if (!block)
+        block = &compileBlock<kState, Opcode>(addr);
+
+    if (block->size == 0
+            || pipe[0] != block->entries[0].instr
+            || pipe[1] != block->entries[1].instr)
+        return false;
+
+    if (config.recompiler && !block->code)
+    {
+        // Code of replaced blocks stays in the buffer until it runs full
+        if (recompiler.isFull())
+        {
+            blocks.clear();
+            recompiler.clear();
+            return false;
+        }
+        block->code = recompiler.compile(*this, *block, addr);
+    }
+
+    uint x = 0;
+    if (config.recompiler && block->code)
+    {
+        x = block->code(*this);
+    }
+    else
+    {
+        while (true)
+        {
+            const auto& entry = block->entries[x];
+
+            pipe[0] = pipe[1];
+            pipe[1] = block->entries[x + 2].instr;
+
+            if (block->cycles)
+                tickRam(block->cycles);
+            else if (kState & State::Thumb)
+                tickRom(pc, waitcnt.waitHalf(pc, pipe.access));
+            else
+                tickRom(pc, waitcnt.waitWord(pc, pipe.access));
+
+            pipe.access = Access::Sequential;
+
+            if ((kState & State::Thumb) || cpsr.check(entry.instr >> 28))
+            {
+                entry.handler(*this, entry.instr);
+            }
+
+            pc += cpsr.size();
+
+            if (++x == block->size
+                    || pc != addr + (x + 2) * kSize
+                    || state != kState
+                    || scheduler.now >= target
+                    || ((kState & State::Irq) && !cpsr.i)
+                    || !block->isValid())
+                break;
+        }
+    }
+
+    if (block->idle && x == block->size && pc == addr + 2 * kSize
+            && state == kState && scheduler.now < target
+            && isIdleMemory(*block, addr, regs))
+        scheduler.run(std::min(target - scheduler.now, scheduler.next - scheduler.now));
+
+    return true;
+}
+
+template<uint kState, typename Opcode>
+Block<Opcode>& Arm::compileBlock(u32 addr)
+{
+    constexpr uint kSize = sizeof(Opcode);
+
+    auto& block = blocks.insert<Opcode>(addr);
+
+    switch (addr >> 24)
+    {
+    case 0x2: block.cycles = kSize == 2 ? 3 : 6; break;
+    case 0x3: block.cycles = 1; break;
+
+    default:
+        block.cycles = 0;
+        break;
+    }
+
+    uint size = BlockCache::kMaxSize;
+    for (u32 fetch = addr; fetch + kSize <= BlockCache::limit(addr); fetch += kSize)
+    {
+        Opcode instr;
+        switch (fetch >> 24)
+        {
+        case 0x2: instr = kSize == 2 ? ewram.readHalf(fetch) : ewram.readWord(fetch); break;
+        case 0x3: instr = kSize == 2 ? iwram.readHalf(fetch) : iwram.readWord(fetch); break;
+
+        default:
+            instr = gamepak.read<Opcode>(fetch);
+            break;
+        }
+
+        // Conditional branches back to the start also end the block, so
+        // that a poll loop forms a block of its own and falls through on exit
+        bool branch;
+        if constexpr (kSize == 2)
+        {
+            block.entries.push_back({ instr_thumb[hashThumb(instr)], instr });
+
+            switch (decodeThumb(hashThumb(instr)))
+            {
+            case InstructionThumb::HighRegisterOperations: branch = bit::seq<8, 2>(instr) == 0b11; break;
+            case InstructionThumb::LongBranchLink:         branch = bit::seq<11, 1>(instr); break;
+            case InstructionThumb::ConditionalBranch:      branch = fetch + 4 + (bit::signEx<8>(bit::seq<0, 8>(u32(instr))) << 1) == addr; break;
+            case InstructionThumb::UnconditionalBranch:
+            case InstructionThumb::SoftwareInterrupt:
+            case InstructionThumb::Undefined:              branch = true; break;
+
+            default:
+                branch = false;
+                break;
+            }
+        }
+        else
+        {
+            block.entries.push_back({ instr_arm[hashArm(instr)], instr });
+
+            switch (decodeArm(hashArm(instr)))
+            {
+            case InstructionArm::BranchLink:
+                branch = (instr >> 28) == 0xE
+                    || fetch + 8 + (bit::signEx<24>(bit::seq<0, 24>(instr)) << 2) == addr;
+                break;
+
+            case InstructionArm::BranchExchange:
+            case InstructionArm::SoftwareInterrupt:
+            case InstructionArm::Undefined: branch = (instr >> 28) == 0xE; break;
+
+            default:
+                branch = false;
+                break;
+            }
+        }
+
+        if (branch)
+            size = std::min<uint>(size, block.entries.size());
+
+        if (block.entries.size() == size + 2)
+            break;
+    }
+
+    block.size = block.entries.size() >= 2
+        ? std::min<uint>(size, block.entries.size() - 2)
+        : 0;
+    block.idle = isIdleLoop(block, addr);
+
+    return block;
+}
+
 void Arm::flushHalf()
 {
     pc &= ~0x1;
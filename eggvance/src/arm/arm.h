@@ -1,8 +1,13 @@
 #pragma once
 
+#include <vector>
+
 #include "bios.h"
+#include "blockcache.h"
 #include "io.h"
+#include "pagetable.h"
 #include "pipeline.h"
+#include "recompiler.h"
 #include "registers.h"
 #include "scheduler/event.h"
 
@@ -14,6 +19,7 @@ class Arm : public Registers
     friend class InterruptEnable;
     friend class InterruptRequest;
     friend class InterruptMaster;
+    friend class Recompiler;
 
     enum class State
     {
@@ -34,8 +40,8 @@ class Arm : public Registers
 private:
     enum class Shift { Lsl, Lsr, Asr, Ror };
 
-    using Instruction32 = void(Arm::*)(u32);
-    using Instruction16 = void(Arm::*)(u16);
+    using Instruction32 = void(*)(Arm&, u32);
+    using Instruction16 = void(*)(Arm&, u16);
 
     static const std::array<Instruction32, 4096> instr_arm;
     static const std::array<Instruction16, 1024> instr_thumb;
@@ -43,6 +49,18 @@ class Arm : public Registers
     template<uint kHash> static constexpr Instruction32 Arm_Decode();
     template<uint kHash> static constexpr Instruction16 Thumb_Decode();
 
+    template<void(Arm::*kHandler)(u32)>
+    static void Arm_Invoke(Arm& arm, u32 instr)
+    {
+        (arm.*kHandler)(instr);
+    }
+
+    template<void(Arm::*kHandler)(u16)>
+    static void Thumb_Invoke(Arm& arm, u16 instr)
+    {
+        (arm.*kHandler)(instr);
+    }
+
     template<bool kImmediate> SHELL_INLINE u32 lsl(u32 value, u32 amount, bool flags = true);
     template<bool kImmediate> SHELL_INLINE u32 lsr(u32 value, u32 amount, bool flags = true);
     template<bool kImmediate> SHELL_INLINE u32 asr(u32 value, u32 amount, bool flags = true);
@@ -54,6 +72,8 @@ class Arm : public Registers
     SHELL_INLINE u32 adc(u32 op1, u32 op2, bool flags = true);
     SHELL_INLINE u32 sbc(u32 op1, u32 op2, bool flags = true);
 
+    void initPages();
+
     u8  readByte(u32 addr, Access access = Access::NonSequential);
     u16 readHalf(u32 addr, Access access = Access::NonSequential);
     u32 readWord(u32 addr, Access access = Access::NonSequential);
@@ -65,6 +85,9 @@ class Arm : public Registers
     u8 readIo(u32 addr);
     void writeIo(u32 addr, u8 byte);
 
+    Page* findBurst(u32 addr, uint count);
+    void endBurst(const Page& page, u32 addr, uint count, bool write);
+
     u32 readUnused() const;
     u32 readHalfRotate(u32 addr, Access access = Access::NonSequential);
     u32 readWordRotate(u32 addr, Access access = Access::NonSequential);
@@ -73,6 +96,10 @@ class Arm : public Registers
 
     template<uint kState> 
     void dispatch();
+    template<uint kState>
+    bool dispatchBlock();
+    template<uint kState, typename Opcode>
+    Block<Opcode>& compileBlock(u32 addr);
     void flushHalf();
     void flushWord();
 
@@ -85,6 +112,20 @@ class Arm : public Registers
     void interruptSw();
     void interruptHandle(u64 late = 0);
 
+    bool swi(uint function);
+    void swiDiv(s32 number, s32 denom);
+    void swiSqrt();
+    void swiArcTan();
+    void swiArcTan2();
+    void swiCpuSet();
+    void swiCpuFastSet();
+    void swiBgAffineSet();
+    void swiObjAffineSet();
+    void swiLz77UnComp(bool vram);
+    bool swiHuffUnComp();
+    void swiRlUnComp(bool vram);
+    void swiWrite(u32 dst, const std::vector<u8>& data, bool vram);
+
     template<u32 kInstr> void Arm_BranchExchange(u32 instr);
     template<u32 kInstr> void Arm_BranchLink(u32 instr);
     template<u32 kInstr> void Arm_DataProcessing(u32 instr);
@@ -135,7 +176,7 @@ class Arm : public Registers
     {
         bool isServable() const;
 
-        Event delay;
+        Event delay{"arm.irq_delay"};
         InterruptEnable enable;
         InterruptRequest request;
         InterruptMaster master;
@@ -146,6 +187,9 @@ class Arm : public Registers
     PostFlag postflg;
 
     Bios bios;
+    BlockCache blocks;
+    Recompiler recompiler;
+    PageTable pages;
     Ram<256 * 1024> ewram = {};
     Ram< 32 * 1024> iwram = {};
 };
@@ -0,0 +1,41 @@
+#include "blockcache.h"
+
+#include "gamepak/gamepak.h"
+
+bool BlockCache::isCacheable(u32 addr)
+{
+    switch (addr >> 24)
+    {
+    case 0x2:
+    case 0x3:
+        return true;
+
+    case 0x8:
+    case 0x9:
+    case 0xA:
+    case 0xB:
+    case 0xC:
+        return !isGpioPage(addr);
+
+    default:
+        return false;
+    }
+}
+
+// The GPIO registers overlay the first page of each ROM mirror. Code there
+// must be fetched through GamePak::read.
+bool BlockCache::isGpioPage(u32 addr)
+{
+    return (addr & (gamepak.rom.mask - 1)) < kPageSize
+        && gamepak.gpio->type != Gpio::Type::None;
+}
+
+u32 BlockCache::limit(u32 addr)
+{
+    return (addr | (kPageSize - 1)) + 1;
+}
+
+const uint* BlockCache::version(u32 addr) const
+{
+    return &versions[page(addr)];
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <shell/array.h>
+
+#include "base/int.h"
+
+class Arm;
+
+template<typename Opcode>
+class Block
+{
+public:
+    using Handler = void(*)(Arm&, Opcode);
+    using Code    = uint(*)(Arm&);
+
+    struct Entry
+    {
+        Handler handler = nullptr;
+        Opcode instr = 0;
+    };
+
+    bool isValid() const
+    {
+        return *version == revision;
+    }
+
+    bool idle = false;
+    uint size = 0;
+    uint cycles = 0;
+    uint revision = 0;
+    const uint* version = nullptr;
+    std::vector<Entry> entries;
+    Code code = nullptr;
+};
+
+class BlockCache
+{
+public:
+    static constexpr uint kPageBits = 8;
+    static constexpr uint kPageSize = 1 << kPageBits;
+    static constexpr uint kMaxSize   = 64;
+    static constexpr uint kMaxBlocks = 16 * 1024;
+
+    static bool isCacheable(u32 addr);
+    static u32 limit(u32 addr);
+
+    const uint* version(u32 addr) const;
+
+    void clear()
+    {
+        blocks_arm.clear();
+        blocks_thumb.clear();
+    }
+
+    void invalidate(u32 addr)
+    {
+        ++versions[page(addr)];
+    }
+
+    void invalidate(u32 addr, u32 size)
+    {
+        for (u32 base = addr & ~(kPageSize - 1); base < addr + size; base += kPageSize)
+            invalidate(base);
+    }
+
+    template<typename Opcode>
+    Block<Opcode>* find(u32 addr)
+    {
+        auto& blocks = this->blocks<Opcode>();
+
+        auto iter = blocks.find(addr);
+        if ( iter != blocks.end() && iter->second.isValid())
+            return &iter->second;
+
+        return nullptr;
+    }
+
+    template<typename Opcode>
+    Block<Opcode>& insert(u32 addr)
+    {
+        auto& blocks = this->blocks<Opcode>();
+
+        // Stale blocks are only replaced when their address runs again, so
+        // drop everything once the cache has grown too large
+        if (blocks.size() >= kMaxBlocks)
+            blocks.clear();
+
+        auto& block = blocks[addr];
+        block.entries.clear();
+        block.code     = nullptr;
+        block.revision = *version(addr);
+        block.version  = version(addr);
+
+        return block;
+    }
+
+private:
+    static constexpr uint kPagesEwram = (256 * 1024) >> kPageBits;
+    static constexpr uint kPagesIwram = ( 32 * 1024) >> kPageBits;
+
+    static bool isGpioPage(u32 addr);
+
+    static uint page(u32 addr)
+    {
+        switch (addr >> 24)
+        {
+        case 0x2: return ((addr & 0x3'FFFF) >> kPageBits);
+        case 0x3: return ((addr & 0x0'7FFF) >> kPageBits) + kPagesEwram;
+
+        default:
+            return kPagesEwram + kPagesIwram;
+        }
+    }
+
+    template<typename Opcode>
+    std::unordered_map<u32, Block<Opcode>>& blocks()
+    {
+        if constexpr (sizeof(Opcode) == sizeof(u16))
+            return blocks_thumb;
+        else
+            return blocks_arm;
+    }
+
+    std::unordered_map<u32, Block<u32>> blocks_arm;
+    std::unordered_map<u32, Block<u16>> blocks_thumb;
+    shell::array<uint, kPagesEwram + kPagesIwram + 1> versions = {};
+};
@@ -0,0 +1,51 @@
+#include "codebuffer.h"
+
+#include <shell/predef.h>
+#include <shell/windows.h>
+
+#if !SHELL_OS_WINDOWS
+#  include <sys/mman.h>
+#endif
+
+CodeBuffer::~CodeBuffer()
+{
+    if (!data)
+        return;
+
+    #if SHELL_OS_WINDOWS
+    VirtualFree(data, 0, MEM_RELEASE);
+    #else
+    munmap(data, kSize);
+    #endif
+}
+
+bool CodeBuffer::init()
+{
+    if (data || failed)
+        return data != nullptr;
+
+    failed = true;
+
+    #if SHELL_OS_WINDOWS
+    void* memory = VirtualAlloc(nullptr, kSize, MEM_COMMIT | MEM_RESERVE, PAGE_EXECUTE_READWRITE);
+    if (!memory)
+        return false;
+    #else
+    void* memory = mmap(nullptr, kSize, PROT_READ | PROT_WRITE | PROT_EXEC, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (memory == MAP_FAILED)
+        return false;
+    #endif
+
+    failed = false;
+
+    data = static_cast<u8*>(memory);
+    head = data;
+    end  = data + kSize;
+
+    return true;
+}
+
+void CodeBuffer::clear()
+{
+    head = data;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "base/int.h"
+
+// Executable memory for recompiled blocks. The memory is mapped on first
+// use and handed out front to back until it is cleared.
+class CodeBuffer
+{
+public:
+    static constexpr uint kSize = 32 * 1024 * 1024;
+
+    CodeBuffer() = default;
+    CodeBuffer(const CodeBuffer&) = delete;
+    CodeBuffer& operator=(const CodeBuffer&) = delete;
+    ~CodeBuffer();
+
+    bool init();
+    void clear();
+
+    uint capacity() const
+    {
+        return static_cast<uint>(end - head);
+    }
+
+    u8* data = nullptr;
+    u8* head = nullptr;
+    u8* end  = nullptr;
+
+private:
+    bool failed = false;
+};
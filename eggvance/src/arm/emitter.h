@@ -0,0 +1,235 @@
+#pragma once
+
+#include "base/int.h"
+
+// Encodes the subset of x86-64 used by the recompiler. Memory operands are
+// always a base register plus a 32-bit displacement.
+class Emitter
+{
+public:
+    enum class Reg
+    {
+        Rax, Rcx, Rdx, Rbx, Rsp, Rbp, Rsi, Rdi,
+        R8,  R9,  R10, R11, R12, R13, R14, R15
+    };
+
+    enum class Cond
+    {
+        O,  No, B,  Ae,
+        E,  Ne, Be, A,
+        S,  Ns, P,  Np,
+        L,  Ge, Le, G
+    };
+
+    enum class Alu { Add, Or, Adc, Sbb, And, Sub, Xor, Cmp };
+    enum class Shift { Rol, Ror, Rcl, Rcr, Shl, Shr, Sal, Sar };
+
+    struct Mem
+    {
+        Reg base;
+        s32 disp;
+    };
+
+    using Label = u8*;
+
+    Emitter(u8* data, u8* end)
+        : head(data), end(end) {}
+
+    u8* pos() const
+    {
+        return head;
+    }
+
+    bool overflow() const
+    {
+        return head > end;
+    }
+
+    void mov(Reg dst, Reg src)       { op(false, 0x89, src, dst); }
+    void mov(Reg dst, Mem src)       { op(false, 0x8B, dst, src); }
+    void mov(Mem dst, Reg src)       { op(false, 0x89, src, dst); }
+    void mov(Mem dst, u32 imm)       { op(false, 0xC7, 0, dst); emit32(imm); }
+    void mov64(Reg dst, Reg src)     { op(true,  0x89, src, dst); }
+    void mov64(Reg dst, Mem src)     { op(true,  0x8B, dst, src); }
+    void mov64(Mem dst, Reg src)     { op(true,  0x89, src, dst); }
+    void mov64(Mem dst, u32 imm)     { op(true,  0xC7, 0, dst); emit32(imm); }
+    void movzxb(Reg dst, Reg src)    { op(false, 0x0FB6, dst, src); }
+
+    void mov(Reg dst, u32 imm)
+    {
+        rex(false, 0, uint(dst));
+        emit8(0xB8 + (uint(dst) & 0x7));
+        emit32(imm);
+    }
+
+    void mov64(Reg dst, u64 imm)
+    {
+        rex(true, 0, uint(dst));
+        emit8(0xB8 + (uint(dst) & 0x7));
+        emit32(static_cast<u32>(imm));
+        emit32(static_cast<u32>(imm >> 32));
+    }
+
+    void alu(Alu alu, Reg dst, Reg src)   { op(false, 8 * uint(alu) + 1, src, dst); }
+    void alu(Alu alu, Reg dst, Mem src)   { op(false, 8 * uint(alu) + 3, dst, src); }
+    void alu(Alu alu, Reg dst, u32 imm)   { op(false, 0x81, uint(alu), dst); emit32(imm); }
+    void alu(Alu alu, Mem dst, Reg src)   { op(false, 8 * uint(alu) + 1, src, dst); }
+    void alu(Alu alu, Mem dst, u32 imm)   { op(false, 0x81, uint(alu), dst); emit32(imm); }
+    void alu64(Alu alu, Reg dst, Mem src) { op(true,  8 * uint(alu) + 3, dst, src); }
+    void alu64(Alu alu, Reg dst, u32 imm) { op(true,  0x81, uint(alu), dst); emit32(imm); }
+    void alu64(Alu alu, Mem dst, u32 imm) { op(true,  0x81, uint(alu), dst); emit32(imm); }
+
+    void test(Reg dst, Reg src)  { op(false, 0x85, src, dst); }
+    void test(Mem dst, u32 imm)  { op(false, 0xF7, 0, dst); emit32(imm); }
+    void bt(Reg dst, Reg bit)    { op(false, 0x0FA3, bit, dst); }
+    void complement(Reg dst)     { op(false, 0xF7, 2, dst); }
+    void negate(Reg dst)         { op(false, 0xF7, 3, dst); }
+
+    void shift(Shift shift, Reg dst, u8 amount)
+    {
+        op(false, 0xC1, uint(shift), dst);
+        emit8(amount);
+    }
+
+    void shiftCl(Shift shift, Reg dst)
+    {
+        op(false, 0xD3, uint(shift), dst);
+    }
+
+    void setcc(Cond cond, Reg dst)
+    {
+        if (uint(dst) >= uint(Reg::Rsp))
+            emit8(0x40 | (uint(dst) >> 3));
+
+        emit8(0x0F);
+        emit8(0x90 + uint(cond));
+        modrm(0, dst);
+    }
+
+    void push(Reg reg)
+    {
+        rex(false, 0, uint(reg));
+        emit8(0x50 + (uint(reg) & 0x7));
+    }
+
+    void pop(Reg reg)
+    {
+        rex(false, 0, uint(reg));
+        emit8(0x58 + (uint(reg) & 0x7));
+    }
+
+    template<typename Function>
+    void call(Function* function)
+    {
+        mov64(Reg::Rax, reinterpret_cast<u64>(function));
+        emit8(0xFF);
+        modrm(2, Reg::Rax);
+    }
+
+    void ret()
+    {
+        emit8(0xC3);
+    }
+
+    Label jcc(Cond cond)
+    {
+        emit8(0x0F);
+        emit8(0x80 + uint(cond));
+        emit32(0);
+
+        return head;
+    }
+
+    Label jmp()
+    {
+        emit8(0xE9);
+        emit32(0);
+
+        return head;
+    }
+
+    void bind(Label label)
+    {
+        bind(label, head);
+    }
+
+    void bind(Label label, const u8* target)
+    {
+        if (label <= end)
+            write32(label - 4, static_cast<u32>(target - label));
+    }
+
+private:
+    void emit8(u8 byte)
+    {
+        if (head < end)
+            *head = byte;
+        head++;
+    }
+
+    void emit32(u32 value)
+    {
+        if (head + 4 <= end)
+            write32(head, value);
+        head += 4;
+    }
+
+    static void write32(u8* dst, u32 value)
+    {
+        for (uint x = 0; x < 4; ++x)
+            dst[x] = static_cast<u8>(value >> (8 * x));
+    }
+
+    void rex(bool w, uint reg, uint rm)
+    {
+        u8 prefix = 0x40 | (w << 3) | ((reg >> 3) << 2) | (rm >> 3);
+        if (prefix != 0x40)
+            emit8(prefix);
+    }
+
+    void opcode(uint opcode)
+    {
+        if (opcode > 0xFF)
+            emit8(opcode >> 8);
+        emit8(opcode);
+    }
+
+    void modrm(uint reg, Reg rm)
+    {
+        emit8(0xC0 | ((reg & 0x7) << 3) | (uint(rm) & 0x7));
+    }
+
+    void modrm(uint reg, Mem rm)
+    {
+        emit8(0x80 | ((reg & 0x7) << 3) | (uint(rm.base) & 0x7));
+
+        // Rsp and R12 as base need a SIB byte
+        if ((uint(rm.base) & 0x7) == uint(Reg::Rsp))
+            emit8(0x24);
+
+        emit32(static_cast<u32>(rm.disp));
+    }
+
+    template<typename Operand>
+    void op(bool w, uint code, Reg reg, Operand rm)
+    {
+        op(w, code, uint(reg), rm);
+    }
+
+    void op(bool w, uint code, uint reg, Reg rm)
+    {
+        rex(w, reg, uint(rm));
+        opcode(code);
+        modrm(reg, rm);
+    }
+
+    void op(bool w, uint code, uint reg, Mem rm)
+    {
+        rex(w, reg, uint(rm.base));
+        opcode(code);
+        modrm(reg, rm);
+    }
+
+    u8* head;
+    u8* end;
+};
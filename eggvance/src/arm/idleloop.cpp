@@ -0,0 +1,461 @@
+#include "idleloop.h"
+
+#include "constants.h"
+#include "decode.h"
+#include "base/bit.h"
+
+inline constexpr auto kFlagNZ = 1 << 16;
+inline constexpr auto kFlagC  = 1 << 17;
+inline constexpr auto kFlagV  = 1 << 18;
+inline constexpr auto kFlags  = kFlagNZ | kFlagC | kFlagV;
+
+struct Operands
+{
+    bool pure = true;
+    uint reads = 0;
+    uint writes = 0;
+    uint clobbers = 0;
+    uint address = 0;
+};
+
+struct Load
+{
+    u32 addr = 0;
+    uint size = 0;
+};
+
+uint conditionReads(uint cond)
+{
+    static constexpr uint kReads[16] =
+    {
+        kFlagNZ, kFlagNZ, kFlagC, kFlagC,
+        kFlagNZ, kFlagNZ, kFlagV, kFlagV,
+        kFlagNZ | kFlagC, kFlagNZ | kFlagC,
+        kFlagNZ | kFlagV, kFlagNZ | kFlagV,
+        kFlagNZ | kFlagV, kFlagNZ | kFlagV,
+        0, 0
+    };
+    return kReads[cond];
+}
+
+Operands operandsThumb(u16 instr)
+{
+    Operands op;
+
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::MoveShiftedRegister:
+        op.reads    = 1 << bit::seq<3, 3>(instr);
+        op.writes   = 1 << bit::seq<0, 3>(instr) | kFlagNZ;
+        op.clobbers = kFlagC;
+        break;
+
+    case InstructionThumb::AddSubtract:
+        op.reads  = 1 << bit::seq<3, 3>(instr);
+        op.writes = 1 << bit::seq<0, 3>(instr) | kFlags;
+        if (!bit::seq<10, 1>(instr))
+            op.reads |= 1 << bit::seq<6, 3>(instr);
+        break;
+
+    case InstructionThumb::ImmediateOperations:
+    {
+        enum class Opcode { Mov, Cmp, Add, Sub };
+
+        uint rd     = bit::seq<8, 3>(instr);
+        uint opcode = bit::seq<11, 2>(instr);
+
+        switch (Opcode(opcode))
+        {
+        case Opcode::Mov: op.writes = 1 << rd | kFlagNZ; break;
+        case Opcode::Cmp: op.reads  = 1 << rd; op.writes = kFlags; break;
+        case Opcode::Add:
+        case Opcode::Sub: op.reads  = 1 << rd; op.writes = 1 << rd | kFlags; break;
+        }
+        break;
+    }
+
+    case InstructionThumb::AluOperations:
+    {
+        enum class Opcode
+        {
+            And, Eor, Lsl, Lsr,
+            Asr, Adc, Sbc, Ror,
+            Tst, Neg, Cmp, Cmn,
+            Orr, Mul, Bic, Mvn
+        };
+
+        uint rd     = bit::seq<0, 3>(instr);
+        uint rs     = bit::seq<3, 3>(instr);
+        uint opcode = bit::seq<6, 4>(instr);
+
+        op.reads  = 1 << rs | 1 << rd;
+        op.writes = 1 << rd | kFlagNZ;
+
+        switch (Opcode(opcode))
+        {
+        case Opcode::Lsl:
+        case Opcode::Lsr:
+        case Opcode::Asr:
+        case Opcode::Ror:
+        case Opcode::Mul:
+            op.clobbers = kFlagC;
+            break;
+
+        case Opcode::Adc:
+        case Opcode::Sbc:
+            op.reads  |= kFlagC;
+            op.writes |= kFlags;
+            break;
+
+        case Opcode::Neg:
+            op.writes |= kFlags;
+            break;
+
+        case Opcode::Tst:
+            op.writes = kFlagNZ;
+            break;
+
+        case Opcode::Cmp:
+        case Opcode::Cmn:
+            op.writes = kFlags;
+            break;
+
+        default:
+            break;
+        }
+        break;
+    }
+
+    case InstructionThumb::HighRegisterOperations:
+    {
+        enum class Opcode { Add, Cmp, Mov, Bx };
+
+        uint rd     = bit::seq<0, 3>(instr) | bit::seq<7, 1>(instr) << 3;
+        uint rs     = bit::seq<3, 4>(instr);
+        uint opcode = bit::seq<8, 2>(instr);
+
+        switch (Opcode(opcode))
+        {
+        case Opcode::Add: op.reads = 1 << rs | 1 << rd; op.writes = 1 << rd; break;
+        case Opcode::Cmp: op.reads = 1 << rs | 1 << rd; op.writes = kFlags; break;
+        case Opcode::Mov: op.reads = 1 << rs; op.writes = 1 << rd; break;
+        case Opcode::Bx:  op.pure  = false; break;
+        }
+        break;
+    }
+
+    case InstructionThumb::LoadPcRelative:
+        op.writes = 1 << bit::seq<8, 3>(instr);
+        break;
+
+    case InstructionThumb::LoadStoreImmediateOffset:
+    case InstructionThumb::LoadStoreHalf:
+        op.pure    = bit::seq<11, 1>(instr);
+        op.reads   = 1 << bit::seq<3, 3>(instr);
+        op.writes  = 1 << bit::seq<0, 3>(instr);
+        op.address = 1 << bit::seq<3, 3>(instr);
+        break;
+
+    case InstructionThumb::LoadStoreSpRelative:
+        op.pure    = bit::seq<11, 1>(instr);
+        op.reads   = 1 << 13;
+        op.writes  = 1 << bit::seq<8, 3>(instr);
+        op.address = 1 << 13;
+        break;
+
+    case InstructionThumb::ConditionalBranch:
+        op.reads = conditionReads(bit::seq<8, 4>(instr));
+        break;
+
+    case InstructionThumb::UnconditionalBranch:
+        break;
+
+    default:
+        op.pure = false;
+        break;
+    }
+    return op;
+}
+
+Operands operandsArm(u32 instr)
+{
+    Operands op;
+
+    uint cond = bit::seq<28, 4>(instr);
+    uint rd   = bit::seq<12, 4>(instr);
+    uint rn   = bit::seq<16, 4>(instr);
+    uint rm   = bit::seq< 0, 4>(instr);
+
+    switch (decodeArm(hashArm(instr)))
+    {
+    case InstructionArm::DataProcessing:
+    {
+        enum class Opcode
+        {
+            And, Eor, Sub, Rsb,
+            Add, Adc, Sbc, Rsc,
+            Tst, Teq, Cmp, Cmn,
+            Orr, Mov, Bic, Mvn
+        };
+
+        uint opcode = bit::seq<21, 4>(instr);
+        uint flags  = bit::seq<20, 1>(instr);
+        uint imm_op = bit::seq<25, 1>(instr);
+
+        bool logical = false;
+        switch (Opcode(opcode))
+        {
+        case Opcode::And:
+        case Opcode::Eor:
+        case Opcode::Tst:
+        case Opcode::Teq:
+        case Opcode::Orr:
+        case Opcode::Mov:
+        case Opcode::Bic:
+        case Opcode::Mvn:
+            logical = true;
+            break;
+
+        case Opcode::Adc:
+        case Opcode::Sbc:
+        case Opcode::Rsc:
+            op.reads |= kFlagC;
+            break;
+
+        default:
+            break;
+        }
+
+        if (!imm_op)
+        {
+            if (bit::seq<4, 1>(instr))
+                op.pure = false;
+
+            op.reads |= 1 << rm;
+            if (bit::seq<5, 7>(instr) == 0b00000'11)
+                op.reads |= kFlagC;
+        }
+
+        if (opcode != Opcode::Mov && opcode != Opcode::Mvn)
+            op.reads |= 1 << rn;
+
+        if ((opcode & 0b1100) != 0b1000)
+            op.writes |= 1 << rd;
+
+        if (flags && logical)
+        {
+            op.writes   |= kFlagNZ;
+            op.clobbers |= kFlagC;
+        }
+        else if (flags)
+        {
+            op.writes |= kFlags;
+        }
+        break;
+    }
+
+    case InstructionArm::SingleDataTransfer:
+        op.pure    = bit::seq<20, 1>(instr) && bit::seq<24, 1>(instr) && !bit::seq<21, 1>(instr) && !bit::seq<25, 1>(instr);
+        op.reads   = 1 << rn;
+        op.writes  = 1 << rd;
+        op.address = 1 << rn & ~(1 << 15);
+        break;
+
+    case InstructionArm::HalfSignedDataTransfer:
+        op.pure    = bit::seq<20, 1>(instr) && bit::seq<24, 1>(instr) && !bit::seq<21, 1>(instr) && bit::seq<22, 1>(instr);
+        op.reads   = 1 << rn;
+        op.writes  = 1 << rd;
+        op.address = 1 << rn & ~(1 << 15);
+        break;
+
+    case InstructionArm::BranchLink:
+        op.pure = !bit::seq<24, 1>(instr);
+        break;
+
+    default:
+        op.pure = false;
+        break;
+    }
+
+    if (cond == 0xF)
+        op.pure = false;
+
+    op.reads |= conditionReads(cond);
+
+    if (cond != 0xE)
+    {
+        op.clobbers |= op.writes;
+        op.writes = 0;
+    }
+    return op;
+}
+
+template<typename Opcode, typename Decode>
+bool isSelfContained(const Block<Opcode>& block, Decode operands)
+{
+    uint reads     = 0;
+    uint writes    = 0;
+    uint clobbers  = 0;
+    uint addresses = 0;
+
+    for (uint x = 0; x < block.size; ++x)
+    {
+        const auto op = operands(block.entries[x].instr);
+        if (!op.pure || (op.writes | op.clobbers) & (1 << 15))
+            return false;
+
+        // Load addresses are recomputed from the registers at the end of
+        // the loop, so their base registers must not change after use
+        addresses |= op.address;
+        if ((op.writes | op.clobbers) & addresses)
+            return false;
+
+        reads    |= op.reads & ~writes;
+        writes   |= op.writes;
+        clobbers |= op.writes | op.clobbers;
+    }
+    return (reads & clobbers) == 0;
+}
+
+// Memory which only changes through scheduler events or not at all
+bool isIdleAddress(u32 addr, uint size)
+{
+    addr &= ~(size - 1);
+
+    switch (addr >> 24)
+    {
+    case 0x2:
+    case 0x3:
+        return true;
+
+    case 0x4:
+        addr &= 0x3FF'FFFF;
+        return (addr >= uint(Io::DisplayStatus) && addr + size <= uint(Io::VerticalCount) + 2)
+            || (addr >= uint(Io::IrqEnable)     && addr + size <= uint(Io::IrqRequest) + 2);
+
+    case 0x8:
+    case 0x9:
+    case 0xA:
+    case 0xB:
+    case 0xC:
+        // Excludes the GPIO port
+        addr &= 0x1FF'FFFF;
+        return addr + size <= 0xC4 || addr >= 0xCA;
+
+    default:
+        return false;
+    }
+}
+
+Load loadThumb(u16 instr, u32 pc, const shell::array<u32, 16>& regs)
+{
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::LoadPcRelative:
+        return { (pc & ~0x3) + 4 * bit::seq<0, 8>(instr), 4 };
+
+    case InstructionThumb::LoadStoreImmediateOffset:
+    {
+        uint size = bit::seq<12, 1>(instr) ? 1 : 4;
+        return { regs[bit::seq<3, 3>(instr)] + size * bit::seq<6, 5>(instr), size };
+    }
+
+    case InstructionThumb::LoadStoreHalf:
+        return { regs[bit::seq<3, 3>(instr)] + 2 * bit::seq<6, 5>(instr), 2 };
+
+    case InstructionThumb::LoadStoreSpRelative:
+        return { regs[13] + 4 * bit::seq<0, 8>(instr), 4 };
+
+    default:
+        return {};
+    }
+}
+
+Load loadArm(u32 instr, u32 pc, const shell::array<u32, 16>& regs)
+{
+    uint rn   = bit::seq<16, 4>(instr);
+    u32  base = rn == 15 ? pc : regs[rn];
+    bool up   = bit::seq<23, 1>(instr);
+
+    switch (decodeArm(hashArm(instr)))
+    {
+    case InstructionArm::SingleDataTransfer:
+    {
+        u32 offset = bit::seq<0, 12>(instr);
+        return { up ? base + offset : base - offset, bit::seq<22, 1>(instr) ? 1u : 4u };
+    }
+
+    case InstructionArm::HalfSignedDataTransfer:
+    {
+        u32 offset = bit::seq<8, 4>(instr) << 4 | bit::seq<0, 4>(instr);
+        return { up ? base + offset : base - offset, bit::seq<5, 2>(instr) == 2 ? 1u : 2u };
+    }
+
+    default:
+        return {};
+    }
+}
+
+template<typename Opcode, typename Decode>
+bool isIdleMemory(const Block<Opcode>& block, u32 addr, const shell::array<u32, 16>& regs, Decode load)
+{
+    constexpr uint kSize = sizeof(Opcode);
+
+    for (uint x = 0; x < block.size; ++x)
+    {
+        const auto access = load(block.entries[x].instr, addr + kSize * (x + 2), regs);
+        if (access.size && !isIdleAddress(access.addr, access.size))
+            return false;
+    }
+    return true;
+}
+
+bool isIdleLoop(const Block<u16>& block, u32 addr)
+{
+    if (block.size == 0)
+        return false;
+
+    u32 instr = block.entries[block.size - 1].instr;
+    u32 dest  = addr + 2 * (block.size - 1) + 4;
+
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::ConditionalBranch:
+        dest += bit::signEx<8>(bit::seq<0, 8>(instr)) << 1;
+        break;
+
+    case InstructionThumb::UnconditionalBranch:
+        dest += bit::signEx<11>(bit::seq<0, 11>(instr)) << 1;
+        break;
+
+    default:
+        return false;
+    }
+    return dest == addr && isSelfContained(block, operandsThumb);
+}
+
+bool isIdleLoop(const Block<u32>& block, u32 addr)
+{
+    if (block.size == 0)
+        return false;
+
+    u32 instr = block.entries[block.size - 1].instr;
+    u32 dest  = addr + 4 * (block.size - 1) + 8;
+
+    if (decodeArm(hashArm(instr)) != InstructionArm::BranchLink || bit::seq<24, 1>(instr))
+        return false;
+
+    dest += bit::signEx<24>(bit::seq<0, 24>(instr)) << 2;
+
+    return dest == addr && isSelfContained(block, operandsArm);
+}
+
+bool isIdleMemory(const Block<u16>& block, u32 addr, const shell::array<u32, 16>& regs)
+{
+    return isIdleMemory(block, addr, regs, loadThumb);
+}
+
+bool isIdleMemory(const Block<u32>& block, u32 addr, const shell::array<u32, 16>& regs)
+{
+    return isIdleMemory(block, addr, regs, loadArm);
+}
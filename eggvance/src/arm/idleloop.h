@@ -0,0 +1,8 @@
+#pragma once
+
+#include "blockcache.h"
+
+bool isIdleLoop(const Block<u16>& block, u32 addr);
+bool isIdleLoop(const Block<u32>& block, u32 addr);
+bool isIdleMemory(const Block<u16>& block, u32 addr, const shell::array<u32, 16>& regs);
+bool isIdleMemory(const Block<u32>& block, u32 addr, const shell::array<u32, 16>& regs);
@@ -1,6 +1,7 @@
 #include "arm.h"
 
 #include "decode.h"
+#include "base/config.h"
 
 template<u32 kInstr>
 void Arm::Arm_BranchExchange(u32 instr)
@@ -504,6 +505,10 @@ void Arm::Arm_BlockDataTransfer(u32 instr)
 
         Access access = Access::NonSequential;
 
+        uint count = bit::popcnt(rlist);
+        u32  first = addr + 4 * pre_index;
+        Page* page = findBurst(first, count);
+
         if (kLoad)
         {
             if (rlist & (1 << rn))
@@ -512,11 +517,14 @@ void Arm::Arm_BlockDataTransfer(u32 instr)
             for (uint x : bit::iterate(rlist))
             {
                 addr += 4 * pre_index;
-                regs[x] = readWord(addr, access);
+                regs[x] = page ? page->read<u32>(addr) : readWord(addr, access);
                 addr += 4 * pre_index ^ 0x4;
                 access = Access::Sequential;
             }
 
+            if (page)
+                endBurst(*page, first, count, false);
+
             idle();
             
             if (rlist & (1 << 15))
@@ -532,13 +540,19 @@ void Arm::Arm_BlockDataTransfer(u32 instr)
                         : regs[x] + 4
                     : x == bit::ctz(rlist)
                         ? base
-                        : base + (kIncrement ? 4 : -4) * bit::popcnt(rlist);
+                        : base + (kIncrement ? 4 : -4) * count;
 
                 addr += 4 * pre_index;
-                writeWord(addr, value, access);
+                if (page)
+                    page->write<u32>(addr, value);
+                else
+                    writeWord(addr, value, access);
                 addr += 4 * pre_index ^ 0x4;
                 access = Access::Sequential;
             }
+
+            if (page)
+                endBurst(*page, first, count, true);
         }
     }
     else
@@ -606,6 +620,9 @@ void Arm::Arm_SingleDataSwap(u32 instr)
 template<u32 kInstr>
 void Arm::Arm_SoftwareInterrupt(u32 instr)
 {
+    if (config.bios_hle && swi(bit::seq<16, 8>(instr)))
+        return;
+
     interruptSw();
 }
 
@@ -639,21 +656,21 @@ constexpr Arm::Instruction32 Arm::Arm_Decode()
     constexpr auto kDehash = dehashArm(kHash);
     constexpr auto kDecode = decodeArm(kHash);
 
-    if constexpr (kDecode == InstructionArm::BranchExchange)               return &Arm::Arm_BranchExchange<kDehash>;
-    if constexpr (kDecode == InstructionArm::BranchLink)                   return &Arm::Arm_BranchLink<kDehash>;
-    if constexpr (kDecode == InstructionArm::DataProcessing)               return &Arm::Arm_DataProcessing<kDehash>;
-    if constexpr (kDecode == InstructionArm::StatusTransfer)               return &Arm::Arm_StatusTransfer<kDehash>;
-    if constexpr (kDecode == InstructionArm::Multiply)                     return &Arm::Arm_Multiply<kDehash>;
-    if constexpr (kDecode == InstructionArm::MultiplyLong)                 return &Arm::Arm_MultiplyLong<kDehash>;
-    if constexpr (kDecode == InstructionArm::SingleDataTransfer)           return &Arm::Arm_SingleDataTransfer<kDehash>;
-    if constexpr (kDecode == InstructionArm::HalfSignedDataTransfer)       return &Arm::Arm_HalfSignedDataTransfer<kDehash>;
-    if constexpr (kDecode == InstructionArm::BlockDataTransfer)            return &Arm::Arm_BlockDataTransfer<kDehash>;
-    if constexpr (kDecode == InstructionArm::SingleDataSwap)               return &Arm::Arm_SingleDataSwap<kDehash>;
-    if constexpr (kDecode == InstructionArm::SoftwareInterrupt)            return &Arm::Arm_SoftwareInterrupt<kDehash>;
-    if constexpr (kDecode == InstructionArm::CoprocessorDataOperations)    return &Arm::Arm_CoprocessorDataOperations<kDehash>;
-    if constexpr (kDecode == InstructionArm::CoprocessorDataTransfers)     return &Arm::Arm_CoprocessorDataTransfers<kDehash>;
-    if constexpr (kDecode == InstructionArm::CoprocessorRegisterTransfers) return &Arm::Arm_CoprocessorRegisterTransfers<kDehash>;
-    if constexpr (kDecode == InstructionArm::Undefined)                    return &Arm::Arm_Undefined<kDehash>;
+    if constexpr (kDecode == InstructionArm::BranchExchange)               return &Arm::Arm_Invoke<&Arm::Arm_BranchExchange<kDehash>>;
+    if constexpr (kDecode == InstructionArm::BranchLink)                   return &Arm::Arm_Invoke<&Arm::Arm_BranchLink<kDehash>>;
+    if constexpr (kDecode == InstructionArm::DataProcessing)               return &Arm::Arm_Invoke<&Arm::Arm_DataProcessing<kDehash>>;
+    if constexpr (kDecode == InstructionArm::StatusTransfer)               return &Arm::Arm_Invoke<&Arm::Arm_StatusTransfer<kDehash>>;
+    if constexpr (kDecode == InstructionArm::Multiply)                     return &Arm::Arm_Invoke<&Arm::Arm_Multiply<kDehash>>;
+    if constexpr (kDecode == InstructionArm::MultiplyLong)                 return &Arm::Arm_Invoke<&Arm::Arm_MultiplyLong<kDehash>>;
+    if constexpr (kDecode == InstructionArm::SingleDataTransfer)           return &Arm::Arm_Invoke<&Arm::Arm_SingleDataTransfer<kDehash>>;
+    if constexpr (kDecode == InstructionArm::HalfSignedDataTransfer)       return &Arm::Arm_Invoke<&Arm::Arm_HalfSignedDataTransfer<kDehash>>;
+    if constexpr (kDecode == InstructionArm::BlockDataTransfer)            return &Arm::Arm_Invoke<&Arm::Arm_BlockDataTransfer<kDehash>>;
+    if constexpr (kDecode == InstructionArm::SingleDataSwap)               return &Arm::Arm_Invoke<&Arm::Arm_SingleDataSwap<kDehash>>;
+    if constexpr (kDecode == InstructionArm::SoftwareInterrupt)            return &Arm::Arm_Invoke<&Arm::Arm_SoftwareInterrupt<kDehash>>;
+    if constexpr (kDecode == InstructionArm::CoprocessorDataOperations)    return &Arm::Arm_Invoke<&Arm::Arm_CoprocessorDataOperations<kDehash>>;
+    if constexpr (kDecode == InstructionArm::CoprocessorDataTransfers)     return &Arm::Arm_Invoke<&Arm::Arm_CoprocessorDataTransfers<kDehash>>;
+    if constexpr (kDecode == InstructionArm::CoprocessorRegisterTransfers) return &Arm::Arm_Invoke<&Arm::Arm_CoprocessorRegisterTransfers<kDehash>>;
+    if constexpr (kDecode == InstructionArm::Undefined)                    return &Arm::Arm_Invoke<&Arm::Arm_Undefined<kDehash>>;
 }
 
 #define DECODE0001(hash) Arm_Decode<hash>(),
@@ -1,6 +1,7 @@
 #include "arm.h"
 
 #include "decode.h"
+#include "base/config.h"
 
 template<u16 kInstr>
 void Arm::Thumb_MoveShiftedRegister(u16 instr)
@@ -401,15 +402,23 @@ void Arm::Thumb_PushPopRegisters(u16 instr)
 
     Access access = Access::NonSequential;
 
+    uint count = bit::popcnt(rlist);
+
     if (kPop)
     {
+        u32 first  = sp;
+        Page* page = findBurst(first, count);
+
         for (uint x : bit::iterate(rlist))
         {
-            regs[x] = readWord(sp, access);
+            regs[x] = page ? page->read<u32>(sp) : readWord(sp, access);
             access = Access::Sequential;
             sp += 4;
         }
 
+        if (page)
+            endBurst(*page, first, count, false);
+
         idle();
 
         if (kRBit)
@@ -417,16 +426,23 @@ void Arm::Thumb_PushPopRegisters(u16 instr)
     }
     else
     {
-        sp -= 4 * bit::popcnt(rlist);
+        sp -= 4 * count;
 
         u32 addr = sp;
+        Page* page = findBurst(addr, count);
 
         for (uint x : bit::iterate(rlist))
         {
-            writeWord(addr, regs[x], access);
+            if (page)
+                page->write<u32>(addr, regs[x]);
+            else
+                writeWord(addr, regs[x], access);
             access = Access::Sequential;
             addr += 4;
         }
+
+        if (page)
+            endBurst(*page, sp, count, true);
     }
 }
 
@@ -447,6 +463,9 @@ void Arm::Thumb_LoadStoreMultiple(u16 instr)
 
     if (rlist != 0)
     {
+        uint count = bit::popcnt(rlist);
+        Page* page = findBurst(addr, count);
+
         if (kLoad)
         {
             if (rlist & (1 << kRb))
@@ -454,10 +473,14 @@ void Arm::Thumb_LoadStoreMultiple(u16 instr)
 
             for (uint x : bit::iterate(rlist))
             {
-                regs[x] = readWord(addr, access);
+                regs[x] = page ? page->read<u32>(addr) : readWord(addr, access);
                 access = Access::Sequential;
                 addr += 4;
             }
+
+            if (page)
+                endBurst(*page, base, count, false);
+
             idle();
         }
         else
@@ -468,12 +491,18 @@ void Arm::Thumb_LoadStoreMultiple(u16 instr)
                     ? regs[x]
                     : x == bit::ctz(rlist)
                         ? base
-                        : base + 4 * bit::popcnt(rlist);
+                        : base + 4 * count;
 
-                writeWord(addr, value, access);
+                if (page)
+                    page->write<u32>(addr, value);
+                else
+                    writeWord(addr, value, access);
                 access = Access::Sequential;
                 addr += 4;
             }
+
+            if (page)
+                endBurst(*page, base, count, true);
         }
     }
     else
@@ -514,6 +543,9 @@ void Arm::Thumb_ConditionalBranch(u16 instr)
 template<u16 kInstr>
 void Arm::Thumb_SoftwareInterrupt(u16 instr)
 {
+    if (config.bios_hle && swi(bit::seq<0, 8>(instr)))
+        return;
+
     interruptSw();
 }
 
@@ -567,26 +599,26 @@ constexpr Arm::Instruction16 Arm::Thumb_Decode()
     constexpr auto kDehash = dehashThumb(kHash);
     constexpr auto kDecode = decodeThumb(kHash);
 
-    if constexpr (kDecode == InstructionThumb::MoveShiftedRegister)      return &Arm::Thumb_MoveShiftedRegister<kDehash>;
-    if constexpr (kDecode == InstructionThumb::AddSubtract)              return &Arm::Thumb_AddSubtract<kDehash>;
-    if constexpr (kDecode == InstructionThumb::ImmediateOperations)      return &Arm::Thumb_ImmediateOperations<kDehash>;
-    if constexpr (kDecode == InstructionThumb::AluOperations)            return &Arm::Thumb_AluOperations<kDehash>;
-    if constexpr (kDecode == InstructionThumb::HighRegisterOperations)   return &Arm::Thumb_HighRegisterOperations<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadPcRelative)           return &Arm::Thumb_LoadPcRelative<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreRegisterOffset)  return &Arm::Thumb_LoadStoreRegisterOffset<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreByteHalf)        return &Arm::Thumb_LoadStoreByteHalf<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreImmediateOffset) return &Arm::Thumb_LoadStoreImmediateOffset<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreHalf)            return &Arm::Thumb_LoadStoreHalf<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreSpRelative)      return &Arm::Thumb_LoadStoreSpRelative<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadRelativeAddress)      return &Arm::Thumb_LoadRelativeAddress<kDehash>;
-    if constexpr (kDecode == InstructionThumb::AddOffsetSp)              return &Arm::Thumb_AddOffsetSp<kDehash>;
-    if constexpr (kDecode == InstructionThumb::PushPopRegisters)         return &Arm::Thumb_PushPopRegisters<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LoadStoreMultiple)        return &Arm::Thumb_LoadStoreMultiple<kDehash>;
-    if constexpr (kDecode == InstructionThumb::ConditionalBranch)        return &Arm::Thumb_ConditionalBranch<kDehash>;
-    if constexpr (kDecode == InstructionThumb::SoftwareInterrupt)        return &Arm::Thumb_SoftwareInterrupt<kDehash>;
-    if constexpr (kDecode == InstructionThumb::UnconditionalBranch)      return &Arm::Thumb_UnconditionalBranch<kDehash>;
-    if constexpr (kDecode == InstructionThumb::LongBranchLink)           return &Arm::Thumb_LongBranchLink<kDehash>;
-    if constexpr (kDecode == InstructionThumb::Undefined)                return &Arm::Thumb_Undefined<kDehash>;
+    if constexpr (kDecode == InstructionThumb::MoveShiftedRegister)      return &Arm::Thumb_Invoke<&Arm::Thumb_MoveShiftedRegister<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::AddSubtract)              return &Arm::Thumb_Invoke<&Arm::Thumb_AddSubtract<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::ImmediateOperations)      return &Arm::Thumb_Invoke<&Arm::Thumb_ImmediateOperations<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::AluOperations)            return &Arm::Thumb_Invoke<&Arm::Thumb_AluOperations<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::HighRegisterOperations)   return &Arm::Thumb_Invoke<&Arm::Thumb_HighRegisterOperations<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadPcRelative)           return &Arm::Thumb_Invoke<&Arm::Thumb_LoadPcRelative<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreRegisterOffset)  return &Arm::Thumb_Invoke<&Arm::Thumb_LoadStoreRegisterOffset<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreByteHalf)        return &Arm::Thumb_Invoke<&Arm::Thumb_LoadStoreByteHalf<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreImmediateOffset) return &Arm::Thumb_Invoke<&Arm::Thumb_LoadStoreImmediateOffset<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreHalf)            return &Arm::Thumb_Invoke<&Arm::Thumb_LoadStoreHalf<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreSpRelative)      return &Arm::Thumb_Invoke<&Arm::Thumb_LoadStoreSpRelative<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadRelativeAddress)      return &Arm::Thumb_Invoke<&Arm::Thumb_LoadRelativeAddress<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::AddOffsetSp)              return &Arm::Thumb_Invoke<&Arm::Thumb_AddOffsetSp<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::PushPopRegisters)         return &Arm::Thumb_Invoke<&Arm::Thumb_PushPopRegisters<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LoadStoreMultiple)        return &Arm::Thumb_Invoke<&Arm::Thumb_LoadStoreMultiple<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::ConditionalBranch)        return &Arm::Thumb_Invoke<&Arm::Thumb_ConditionalBranch<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::SoftwareInterrupt)        return &Arm::Thumb_Invoke<&Arm::Thumb_SoftwareInterrupt<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::UnconditionalBranch)      return &Arm::Thumb_Invoke<&Arm::Thumb_UnconditionalBranch<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::LongBranchLink)           return &Arm::Thumb_Invoke<&Arm::Thumb_LongBranchLink<kDehash>>;
+    if constexpr (kDecode == InstructionThumb::Undefined)                return &Arm::Thumb_Invoke<&Arm::Thumb_Undefined<kDehash>>;
 }
 
 #define DECODE0001(hash) Thumb_Decode<hash>(),
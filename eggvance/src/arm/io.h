@@ -20,6 +20,8 @@ class HaltControl : public RegisterW<u8>
 class WaitControl : public Register<u16>
 {
 public:
+    friend class Recompiler;
+
     WaitControl();
 
     void write(uint index, u8 byte);
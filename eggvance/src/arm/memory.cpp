@@ -24,10 +24,48 @@ enum class Region
     SaveH
 };
 
+void Arm::initPages()
+{
+    pages.clear();
+
+    for (u32 addr = 0; addr < 0x0100'0000; addr += PageTable::kPageSize)
+    {
+        pages.map(addr + 0x0200'0000, ewram.data() + ewram.mirror(addr), PageTable::kPageSize - 1, 3, 6, true);
+        pages.map(addr + 0x0300'0000, iwram.data() + iwram.mirror(addr), PageTable::kPageSize - 1, 1, 1, true);
+        pages.map(addr + 0x0500'0000, ppu.pram.data(), ppu.pram.size() - 1, 1, 2);
+        pages.map(addr + 0x0600'0000, ppu.vram.data() + ppu.vram.mirror(addr), PageTable::kPageSize - 1, 1, 2);
+        pages.map(addr + 0x0700'0000, ppu.oam.data(), ppu.oam.size() - 1, 1, 1);
+    }
+
+    // Mirrored ROMs repeat every rom.mask bytes. Masks which do not cover
+    // whole pages are left to GamePak::read.
+    const u32 mask = gamepak.rom.mask;
+    if (mask % PageTable::kPageSize || (mask & (mask - 1)))
+        return;
+
+    for (u32 addr = 0x0800'0000; addr < 0x0D00'0000; addr += PageTable::kPageSize)
+    {
+        if ((addr & (mask - 1)) == 0 && gamepak.gpio->type != Gpio::Type::None)
+            continue;
+
+        pages.map(addr, gamepak.rom.data() + (addr & (mask - 1)), PageTable::kPageSize - 1, 0, 0);
+    }
+}
+
 u8 Arm::readByte(u32 addr, Access access)
 {
     pipe.access = Access::NonSequential;
 
+    if (const Page* page = pages.find(addr))
+    {
+        if (page->wait_half)
+            tickRam(page->wait_half);
+        else
+            tickRom(addr, waitcnt.waitHalf(addr, access));
+
+        return page->read<u8>(addr);
+    }
+
     switch (Region(addr >> 24))
     {
     case Region::Bios:
@@ -91,6 +129,16 @@ u16 Arm::readHalf(u32 addr, Access access)
 {
     pipe.access = Access::NonSequential;
 
+    if (const Page* page = pages.find(addr))
+    {
+        if (page->wait_half)
+            tickRam(page->wait_half);
+        else
+            tickRom(addr, waitcnt.waitHalf(addr, access));
+
+        return page->read<u16>(addr);
+    }
+
     switch (Region(addr >> 24))
     {
     case Region::Bios:
@@ -162,6 +210,16 @@ u32 Arm::readWord(u32 addr, Access access)
 {
     pipe.access = Access::NonSequential;
 
+    if (const Page* page = pages.find(addr))
+    {
+        if (page->wait_word)
+            tickRam(page->wait_word);
+        else
+            tickRom(addr, waitcnt.waitWord(addr, access));
+
+        return page->read<u32>(addr);
+    }
+
     switch (Region(addr >> 24))
     {
     case Region::Bios:
@@ -235,6 +293,14 @@ void Arm::writeByte(u32 addr, u8 byte, Access access)
 {
     pipe.access = Access::NonSequential;
 
+    if (Page* page = pages.find(addr); page && page->writable)
+    {
+        tickRam(page->wait_half);
+        page->write<u8>(addr, byte);
+        blocks.invalidate(addr);
+        return;
+    }
+
     switch (Region(addr >> 24))
     {
     case Region::Bios:
@@ -245,11 +311,13 @@ void Arm::writeByte(u32 addr, u8 byte, Access access)
     case Region::ExternalWorkRam:
         tickRam(3);
         ewram.writeByte(addr, byte);
+        blocks.invalidate(addr);
         break;
 
     case Region::InternalWorkRam:
         tickRam(1);
         iwram.writeByte(addr, byte);
+        blocks.invalidate(addr);
         break;
 
     case Region::Io:
@@ -262,11 +330,13 @@ void Arm::writeByte(u32 addr, u8 byte, Access access)
 
     case Region::PaletteRam:
         tickRam(1);
+        ppu.sync();
         ppu.pram.writeByte(addr, byte);
         break;
 
     case Region::VideoRam:
         tickRam(1);
+        ppu.sync();
         ppu.vram.writeByte(addr, byte);
         break;
 
@@ -299,7 +369,15 @@ void Arm::writeByte(u32 addr, u8 byte, Access access)
 void Arm::writeHalf(u32 addr, u16 half, Access access)
 {
     pipe.access = Access::NonSequential;
-    
+
+    if (Page* page = pages.find(addr); page && page->writable)
+    {
+        tickRam(page->wait_half);
+        page->write<u16>(addr, half);
+        blocks.invalidate(addr);
+        return;
+    }
+
     switch (Region(addr >> 24))
     {
     case Region::Bios:
@@ -310,11 +388,13 @@ void Arm::writeHalf(u32 addr, u16 half, Access access)
     case Region::ExternalWorkRam:
         tickRam(3);
         ewram.writeHalf(addr, half);
+        blocks.invalidate(addr);
         break;
 
     case Region::InternalWorkRam:
         tickRam(1);
         iwram.writeHalf(addr, half);
+        blocks.invalidate(addr);
         break;
 
     case Region::Io:
@@ -328,16 +408,19 @@ void Arm::writeHalf(u32 addr, u16 half, Access access)
 
     case Region::PaletteRam:
         tickRam(1);
+        ppu.sync();
         ppu.pram.writeHalf(addr, half);
         break;
 
     case Region::VideoRam:
         tickRam(1);
+        ppu.sync();
         ppu.vram.writeHalf(addr, half);
         break;
 
     case Region::Oam:
         tickRam(1);
+        ppu.sync();
         ppu.oam.writeHalf(addr, half);
         break;
 
@@ -366,7 +449,15 @@ void Arm::writeHalf(u32 addr, u16 half, Access access)
 void Arm::writeWord(u32 addr, u32 word, Access access)
 {
     pipe.access = Access::NonSequential;
-    
+
+    if (Page* page = pages.find(addr); page && page->writable)
+    {
+        tickRam(page->wait_word);
+        page->write<u32>(addr, word);
+        blocks.invalidate(addr);
+        return;
+    }
+
     switch (Region(addr >> 24))
     {
     case Region::Bios:
@@ -377,11 +468,13 @@ void Arm::writeWord(u32 addr, u32 word, Access access)
     case Region::ExternalWorkRam:
         tickRam(6);
         ewram.writeWord(addr, word);
+        blocks.invalidate(addr);
         break;
 
     case Region::InternalWorkRam:
         tickRam(1);
         iwram.writeWord(addr, word);
+        blocks.invalidate(addr);
         break;
 
     case Region::Io:
@@ -397,16 +490,19 @@ void Arm::writeWord(u32 addr, u32 word, Access access)
 
     case Region::PaletteRam:
         tickRam(2);
+        ppu.sync();
         ppu.pram.writeWord(addr, word);
         break;
 
     case Region::VideoRam:
         tickRam(2);
+        ppu.sync();
         ppu.vram.writeWord(addr, word);
         break;
 
     case Region::Oam:
         tickRam(1);
+        ppu.sync();
         ppu.oam.writeWord(addr, word);
         break;
 
@@ -432,6 +528,31 @@ void Arm::writeWord(u32 addr, u32 word, Access access)
     }
 }
 
+Page* Arm::findBurst(u32 addr, uint count)
+{
+    Page* page = pages.find(addr & ~0x3, 4 * count);
+
+    // Bursts tick all accesses at once, so they must end before the next
+    // event could observe one of them
+    if (page && scheduler.now + count * page->wait_word >= scheduler.next)
+        return nullptr;
+
+    return page;
+}
+
+void Arm::endBurst(const Page& page, u32 addr, uint count, bool write)
+{
+    pipe.access = Access::NonSequential;
+
+    tickRam(count * page.wait_word);
+
+    if (write)
+    {
+        blocks.invalidate(addr);
+        blocks.invalidate(addr + 4 * count - 4);
+    }
+}
+
 u32 Arm::readUnused() const
 {
     if (cpsr.t == 0)
@@ -74,6 +74,9 @@ u8 Arm::readIo(u32 addr)
 
 void Arm::writeIo(u32 addr, u8 byte)
 {
+    if (addr < uint(Io::SoundSquare1))
+        ppu.sync();
+
     switch (addr)
     {
     SHELL_CASE02(uint(Io::DisplayControl), ppu.dispcnt.write(kIndex, byte));
@@ -120,8 +123,8 @@ void Arm::writeIo(u32 addr, u8 byte)
     SHELL_CASE08(uint(Io::SoundControl),   apu.control.write(kIndex, byte));
     SHELL_CASE02(uint(Io::SoundBias),      apu.bias.write(kIndex, byte));
     SHELL_CASE16(uint(Io::WaveRam),        apu.wave.ram.write(kIndex, byte));
-    SHELL_CASE04(uint(Io::FifoA),          apu.fifos[0].write(byte));
-    SHELL_CASE04(uint(Io::FifoB),          apu.fifos[1].write(byte));
+    SHELL_CASE04(uint(Io::FifoA),          apu.push(0, byte));
+    SHELL_CASE04(uint(Io::FifoB),          apu.push(1, byte));
     SHELL_CASE04(uint(Io::Dma0Sad),        dma.channels[0].sad.write(kIndex, byte));
     SHELL_CASE04(uint(Io::Dma0Dad),        dma.channels[0].dad.write(kIndex, byte));
     SHELL_CASE02(uint(Io::Dma0Count),      dma.channels[0].count.write(kIndex, byte));
@@ -0,0 +1,20 @@
+#include "pagetable.h"
+
+#include <algorithm>
+
+void PageTable::clear()
+{
+    std::fill(pages.begin(), pages.end(), Page());
+}
+
+void PageTable::map(u32 addr, u8* data, u32 mask, u8 wait_half, u8 wait_word, bool writable)
+{
+    SHELL_ASSERT(addr < kLimit);
+
+    Page& page = pages[addr >> kPageBits];
+    page.data      = data;
+    page.mask      = mask;
+    page.wait_half = wait_half;
+    page.wait_word = wait_word;
+    page.writable  = writable;
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <shell/array.h>
+#include <shell/macros.h>
+#include <shell/punning.h>
+
+#include "base/int.h"
+
+class Page
+{
+public:
+    template<typename Integral>
+    Integral read(u32 addr) const
+    {
+        return shell::read<Integral>(data, addr & mask & ~(sizeof(Integral) - 1));
+    }
+
+    template<typename Integral>
+    void write(u32 addr, Integral value)
+    {
+        shell::write(data, addr & mask & ~(sizeof(Integral) - 1), value);
+    }
+
+    u8* data = nullptr;
+    u32 mask = 0;
+    u8 wait_half = 0;
+    u8 wait_word = 0;
+    bool writable = false;
+};
+
+class PageTable
+{
+public:
+    static constexpr uint kPageBits = 15;
+    static constexpr uint kPageSize = 1 << kPageBits;
+
+    void clear();
+    void map(u32 addr, u8* data, u32 mask, u8 wait_half, u8 wait_word, bool writable = false);
+
+    SHELL_INLINE Page* find(u32 addr)
+    {
+        if (addr >= kLimit)
+            return nullptr;
+
+        Page& page = pages[addr >> kPageBits];
+
+        return page.data ? &page : nullptr;
+    }
+
+    SHELL_INLINE Page* find(u32 addr, u32 size)
+    {
+        if ((addr >> kPageBits) != ((addr + size - 1) >> kPageBits))
+            return nullptr;
+
+        Page* page = find(addr);
+
+        return page && page->writable ? page : nullptr;
+    }
+
+private:
+    static constexpr u32 kLimit = 0x1000'0000;
+
+    shell::array<Page, (kLimit >> kPageBits)> pages = {};
+};
@@ -30,38 +30,3 @@ Psr::operator u32() const
         | (z << 30)
         | (n << 31);
 }
-
-uint Psr::size() const
-{
-    return 4 >> t;
-}
-
-void Psr::setZ(u32 value)
-{
-    z = value == 0;
-}
-
-void Psr::setN(u32 value)
-{
-    n = bit::msb(value);
-}
-
-void Psr::setCAdd(u64 op1, u64 op2)
-{
-    c = op1 + op2 > 0xFFFF'FFFF;
-}
-
-void Psr::setCSub(u64 op1, u64 op2)
-{
-    c = op2 <= op1;
-}
-
-void Psr::setVAdd(u32 op1, u32 op2, u32 res)
-{
-    v = bit::msb((op1 ^ res) & (~op1 ^ op2));
-}
-
-void Psr::setVSub(u32 op1, u32 op2, u32 res)
-{
-    v = bit::msb((op1 ^ op2) & (~op2 ^ res));
-}
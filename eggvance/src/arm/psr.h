@@ -1,9 +1,58 @@
 #pragma once
 
+#include <array>
 #include <shell/macros.h>
 
+#include "base/bit.h"
 #include "base/int.h"
 
+enum class Condition
+{
+    EQ, NE, CS, CC,
+    MI, PL, VS, VC,
+    HI, LS, GE, LT,
+    GT, LE, AL, NV
+};
+
+constexpr bool checkCondition(Condition condition, bool n, bool z, bool c, bool v)
+{
+    switch (condition)
+    {
+    case Condition::EQ: return z;
+    case Condition::NE: return !z;
+    case Condition::CS: return c;
+    case Condition::CC: return !c;
+    case Condition::MI: return n;
+    case Condition::PL: return !n;
+    case Condition::VS: return v;
+    case Condition::VC: return !v;
+    case Condition::HI: return c && !z;
+    case Condition::LS: return !c || z;
+    case Condition::GE: return n == v;
+    case Condition::LT: return n != v;
+    case Condition::GT: return !z && (n == v);
+    case Condition::LE: return z || (n != v);
+    case Condition::AL: return true;
+    case Condition::NV: return false;
+    }
+    return false;
+}
+
+inline constexpr auto kConditions = []()
+{
+    std::array<u16, 16> conditions = {};
+
+    for (uint flags = 0; flags < 16; ++flags)
+    {
+        for (uint condition = 0; condition < 16; ++condition)
+        {
+            if (checkCondition(Condition(condition), flags & 0x8, flags & 0x4, flags & 0x2, flags & 0x1))
+                conditions[flags] |= 1 << condition;
+        }
+    }
+    return conditions;
+}();
+
 class Psr
 {
 public:
@@ -21,47 +70,44 @@ class Psr
     Psr& operator=(u32 value);
     operator u32() const;
 
-    uint size() const;
-    void setZ(u32 value);
-    void setN(u32 value);
-    void setCAdd(u64 op1, u64 op2);
-    void setCSub(u64 op1, u64 op2);
-    void setVAdd(u32 op1, u32 op2, u32 res);
-    void setVSub(u32 op1, u32 op2, u32 res);
+    SHELL_INLINE uint size() const
+    {
+        return 4 >> t;
+    }
+
+    SHELL_INLINE void setZ(u32 value)
+    {
+        z = value == 0;
+    }
+
+    SHELL_INLINE void setN(u32 value)
+    {
+        n = bit::msb(value);
+    }
+
+    SHELL_INLINE void setCAdd(u64 op1, u64 op2)
+    {
+        c = op1 + op2 > 0xFFFF'FFFF;
+    }
+
+    SHELL_INLINE void setCSub(u64 op1, u64 op2)
+    {
+        c = op2 <= op1;
+    }
+
+    SHELL_INLINE void setVAdd(u32 op1, u32 op2, u32 res)
+    {
+        v = bit::msb((op1 ^ res) & (~op1 ^ op2));
+    }
+
+    SHELL_INLINE void setVSub(u32 op1, u32 op2, u32 res)
+    {
+        v = bit::msb((op1 ^ op2) & (~op2 ^ res));
+    }
 
     SHELL_INLINE bool check(uint condition) const
     {
-        enum class Condition
-        { 
-            EQ, NE, CS, CC,
-            MI, PL, VS, VC,
-            HI, LS, GE, LT,
-            GT, LE, AL, NV
-        };
-
-        switch (Condition(condition))
-        {
-        case Condition::EQ: return z;
-        case Condition::NE: return !z;
-        case Condition::CS: return c;
-        case Condition::CC: return !c;
-        case Condition::MI: return n;
-        case Condition::PL: return !n;
-        case Condition::VS: return v;
-        case Condition::VC: return !v;
-        case Condition::HI: return c && !z;
-        case Condition::LS: return !c || z;
-        case Condition::GE: return n == v;
-        case Condition::LT: return n != v;
-        case Condition::GT: return !z && (n == v);
-        case Condition::LE: return z || (n != v);
-        case Condition::AL: return true;
-        case Condition::NV: return false;
-
-        default:
-            SHELL_UNREACHABLE;
-            return false;
-        }
+        return kConditions[n << 3 | z << 2 | c << 1 | v] & (1 << condition);
     }
 
     Mode m = Mode::Svc;
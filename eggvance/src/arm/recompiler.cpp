@@ -0,0 +1,658 @@
+#include "recompiler.h"
+
+#include <shell/predef.h>
+
+#include "arm.h"
+#include "decode.h"
+#include "scheduler/scheduler.h"
+
+using Alu   = Emitter::Alu;
+using Shift = Emitter::Shift;
+
+#if SHELL_OS_WINDOWS
+inline constexpr auto kRegArg0 = Emitter::Reg::Rcx;
+inline constexpr auto kRegArg1 = Emitter::Reg::Rdx;
+#else
+inline constexpr auto kRegArg0 = Emitter::Reg::Rdi;
+inline constexpr auto kRegArg1 = Emitter::Reg::Rsi;
+#endif
+
+// Callee-saved registers which hold the CPU, the scheduler and the CPU
+// state at block entry
+inline constexpr auto kRegArm       = Emitter::Reg::Rbx;
+inline constexpr auto kRegScheduler = Emitter::Reg::Rbp;
+inline constexpr auto kRegState     = Emitter::Reg::R12;
+
+template<typename Opcode>
+typename Block<Opcode>::Code Recompiler::compile(Arm& arm, const Block<Opcode>& block, u32 addr)
+{
+    constexpr uint kSize = sizeof(Opcode);
+
+    if (!kSupported || !buffer.init())
+        return nullptr;
+
+    Emitter emitter(buffer.head, buffer.end);
+
+    this->arm  = &arm;
+    this->emit = &emitter;
+
+    std::vector<Emitter::Label> exits;
+
+    // Three pushes and the shadow space keep the stack 16-byte aligned
+    emitter.push(kRegArm);
+    emitter.push(kRegScheduler);
+    emitter.push(kRegState);
+    emitter.alu64(Alu::Sub, Reg::Rsp, 32);
+    emitter.mov64(kRegArm, kRegArg0);
+    emitter.mov64(kRegScheduler, reinterpret_cast<u64>(&scheduler));
+    emitter.mov(kRegState, field(&arm.state));
+
+    for (uint x = 0; x < block.size; ++x)
+    {
+        const auto& entry = block.entries[x];
+
+        const u32 pc = addr + (x + 2) * kSize;
+
+        emitter.mov(field(&arm.pipe[0]), block.entries[x + 1].instr);
+        emitter.mov(field(&arm.pipe[1]), block.entries[x + 2].instr);
+
+        if (block.cycles)
+            emitTickRam(block.cycles);
+        else
+            emitTickRom<Opcode>(pc);
+
+        emitter.mov(field(&arm.pipe.access), uint(Access::Sequential));
+
+        std::vector<Emitter::Label> skip;
+
+        bool native;
+        if constexpr (kSize == 2)
+        {
+            native = emitThumb(entry.instr);
+        }
+        else
+        {
+            emitCondition(entry.instr >> 28, skip);
+            native = emitArm(entry.instr);
+        }
+
+        if (!native)
+            call(entry.handler, entry.instr);
+
+        for (const auto& label : skip)
+            emitter.bind(label);
+
+        // Inline instructions cannot change the state, so pc only needs to
+        // be checked after handlers
+        if (native)
+        {
+            emitter.alu(Alu::Add, field(&arm.pc), kSize);
+        }
+        else
+        {
+            emitter.mov(Reg::Rcx, field(&arm.cpsr.t));
+            emitter.mov(Reg::Rax, 4);
+            emitter.shiftCl(Shift::Shr, Reg::Rax);
+            emitter.alu(Alu::Add, field(&arm.pc), Reg::Rax);
+        }
+
+        emitter.mov(Reg::Rax, x + 1);
+
+        if (x + 1 == block.size)
+            break;
+
+        if (!native)
+        {
+            emitter.alu(Alu::Cmp, field(&arm.pc), pc + kSize);
+            exits.push_back(emitter.jcc(Cond::Ne));
+        }
+
+        emitter.alu(Alu::Cmp, kRegState, field(&arm.state));
+        exits.push_back(emitter.jcc(Cond::Ne));
+
+        emitter.mov64(Reg::Rcx, now());
+        emitter.alu64(Alu::Cmp, Reg::Rcx, field(&arm.target));
+        exits.push_back(emitter.jcc(Cond::Ae));
+
+        if (!native)
+        {
+            emitter.test(field(&arm.state), uint(Arm::State::Irq));
+            auto enabled = emitter.jcc(Cond::E);
+            emitter.alu(Alu::Cmp, field(&arm.cpsr.i), 0);
+            exits.push_back(emitter.jcc(Cond::E));
+            emitter.bind(enabled);
+        }
+
+        emitter.mov64(Reg::Rcx, reinterpret_cast<u64>(block.version));
+        emitter.mov(Reg::Rcx, Mem{ Reg::Rcx, 0 });
+        emitter.alu(Alu::Cmp, Reg::Rcx, block.revision);
+        exits.push_back(emitter.jcc(Cond::Ne));
+    }
+
+    for (const auto& label : exits)
+        emitter.bind(label);
+
+    emitter.alu64(Alu::Add, Reg::Rsp, 32);
+    emitter.pop(kRegState);
+    emitter.pop(kRegScheduler);
+    emitter.pop(kRegArm);
+    emitter.ret();
+
+    if (emitter.overflow())
+        return nullptr;
+
+    u8* code = buffer.head;
+    buffer.head = emitter.pos();
+
+    return reinterpret_cast<typename Block<Opcode>::Code>(code);
+}
+
+template Block<u16>::Code Recompiler::compile(Arm&, const Block<u16>&, u32);
+template Block<u32>::Code Recompiler::compile(Arm&, const Block<u32>&, u32);
+
+void Recompiler::tickRam(Arm& arm, uint cycles)
+{
+    arm.tickRam(cycles);
+}
+
+template<typename Opcode>
+void Recompiler::tickRom(Arm& arm)
+{
+    if constexpr (sizeof(Opcode) == 2)
+        arm.tickRom(arm.pc, arm.waitcnt.waitHalf(arm.pc, arm.pipe.access));
+    else
+        arm.tickRom(arm.pc, arm.waitcnt.waitWord(arm.pc, arm.pipe.access));
+}
+
+Emitter::Mem Recompiler::field(const void* member) const
+{
+    return { kRegArm, static_cast<s32>(static_cast<const u8*>(member) - reinterpret_cast<const u8*>(arm)) };
+}
+
+Emitter::Mem Recompiler::reg(uint index) const
+{
+    return field(&arm->regs[index]);
+}
+
+Emitter::Mem Recompiler::now()
+{
+    return { kRegScheduler, static_cast<s32>(reinterpret_cast<const u8*>(&scheduler.now) - reinterpret_cast<const u8*>(&scheduler)) };
+}
+
+Emitter::Mem Recompiler::next()
+{
+    return { kRegScheduler, static_cast<s32>(reinterpret_cast<const u8*>(&scheduler.next) - reinterpret_cast<const u8*>(&scheduler)) };
+}
+
+template<typename Function>
+void Recompiler::call(Function* function, u32 arg)
+{
+    emit->mov64(kRegArg0, kRegArm);
+    emit->mov(kRegArg1, arg);
+    emit->call(function);
+}
+
+void Recompiler::storeFlag(Cond cond, const uint& flag)
+{
+    emit->setcc(cond, Reg::Rdx);
+    emit->movzxb(Reg::Rdx, Reg::Rdx);
+    emit->mov(field(&flag), Reg::Rdx);
+}
+
+void Recompiler::storeFlagsNz()
+{
+    storeFlag(Cond::S, arm->cpsr.n);
+    storeFlag(Cond::E, arm->cpsr.z);
+}
+
+void Recompiler::storeFlagsNzcv(bool sub)
+{
+    storeFlagsNz();
+    storeFlag(sub ? Cond::Ae : Cond::B, arm->cpsr.c);
+    storeFlag(Cond::O, arm->cpsr.v);
+}
+
+void Recompiler::emitTickRam(uint cycles)
+{
+    emit->alu64(Alu::Cmp, field(&arm->prefetch.active), 0);
+    auto prefetch = emit->jcc(Cond::Ne);
+
+    emit->mov64(Reg::Rax, now());
+    emit->alu64(Alu::Add, Reg::Rax, cycles);
+    emit->alu64(Alu::Cmp, Reg::Rax, next());
+    auto process = emit->jcc(Cond::Ae);
+    emit->mov64(now(), Reg::Rax);
+    auto done = emit->jmp();
+
+    emit->bind(prefetch);
+    emit->bind(process);
+    call(&Recompiler::tickRam, cycles);
+    emit->bind(done);
+}
+
+template<typename Opcode>
+void Recompiler::emitTickRom(u32 pc)
+{
+    constexpr uint kS = uint(Access::Sequential);
+
+    const auto& wait = sizeof(Opcode) == 2
+        ? arm->waitcnt.wait.half
+        : arm->waitcnt.wait.word;
+
+    // Sequential fetches without buffered prefetch cycles are the common
+    // case, everything else goes through Arm::tickRom
+    emit->alu(Alu::Cmp, field(&arm->pipe.access), kS);
+    auto non_sequential = emit->jcc(Cond::Ne);
+    emit->alu(Alu::Cmp, field(&arm->waitcnt.prefetch), 0);
+    auto disabled = emit->jcc(Cond::E);
+    emit->alu64(Alu::Cmp, field(&arm->prefetch.cycles), 0);
+    auto buffered = emit->jcc(Cond::Ne);
+    emit->mov64(field(&arm->prefetch.active), 1);
+    emit->bind(disabled);
+
+    emit->mov64(Reg::Rcx, reinterpret_cast<u64>(&wait[(pc >> 25) & 0x3][kS]));
+    emit->mov64(Reg::Rax, now());
+    emit->alu64(Alu::Add, Reg::Rax, Mem{ Reg::Rcx, 0 });
+    emit->alu64(Alu::Cmp, Reg::Rax, next());
+    auto process = emit->jcc(Cond::Ae);
+    emit->mov64(now(), Reg::Rax);
+    auto done = emit->jmp();
+
+    emit->bind(non_sequential);
+    emit->bind(buffered);
+    emit->bind(process);
+    call(&Recompiler::tickRom<Opcode>, 0);
+    emit->bind(done);
+}
+
+void Recompiler::emitCondition(uint condition, std::vector<Emitter::Label>& skip)
+{
+    if (condition == uint(Condition::AL))
+        return;
+
+    // Bit n << 3 | z << 2 | c << 1 | v of the mask is set if the condition
+    // passes for these flags
+    u32 mask = 0;
+    for (uint flags = 0; flags < 16; ++flags)
+    {
+        if (kConditions[flags] & (1 << condition))
+            mask |= 1 << flags;
+    }
+
+    emit->mov(Reg::Rax, field(&arm->cpsr.n));
+    emit->alu(Alu::Add, Reg::Rax, Reg::Rax);
+    emit->alu(Alu::Or,  Reg::Rax, field(&arm->cpsr.z));
+    emit->alu(Alu::Add, Reg::Rax, Reg::Rax);
+    emit->alu(Alu::Or,  Reg::Rax, field(&arm->cpsr.c));
+    emit->alu(Alu::Add, Reg::Rax, Reg::Rax);
+    emit->alu(Alu::Or,  Reg::Rax, field(&arm->cpsr.v));
+    emit->mov(Reg::Rcx, mask);
+    emit->bt(Reg::Rcx, Reg::Rax);
+    skip.push_back(emit->jcc(Cond::Ae));
+}
+
+bool Recompiler::emitArm(u32 instr)
+{
+    enum class Opcode
+    {
+        And, Eor, Sub, Rsb,
+        Add, Adc, Sbc, Rsc,
+        Tst, Teq, Cmp, Cmn,
+        Orr, Mov, Bic, Mvn
+    };
+
+    if (decodeArm(hashArm(instr)) != InstructionArm::DataProcessing)
+        return false;
+
+    uint flags  = bit::seq<20, 1>(instr);
+    uint opcode = bit::seq<21, 4>(instr);
+    uint imm_op = bit::seq<25, 1>(instr);
+    uint rd     = bit::seq<12, 4>(instr);
+    uint rn     = bit::seq<16, 4>(instr);
+    uint rm     = bit::seq< 0, 4>(instr);
+    uint reg_op = bit::seq< 4, 1>(instr);
+    uint shift  = bit::seq< 5, 2>(instr);
+    uint amount = bit::seq< 7, 5>(instr);
+
+    bool logical =
+           opcode == Opcode::And
+        || opcode == Opcode::Eor
+        || opcode == Opcode::Orr
+        || opcode == Opcode::Mov
+        || opcode == Opcode::Bic
+        || opcode == Opcode::Mvn
+        || opcode == Opcode::Tst
+        || opcode == Opcode::Teq;
+
+    bool compare =
+           opcode == Opcode::Tst
+        || opcode == Opcode::Teq
+        || opcode == Opcode::Cmp
+        || opcode == Opcode::Cmn;
+
+    bool unary = opcode == Opcode::Mov || opcode == Opcode::Mvn;
+
+    // Carry input, pc operands, register shifts and the special meanings of
+    // a zero shift amount are left to the interpreter
+    if (opcode == Opcode::Adc || opcode == Opcode::Sbc || opcode == Opcode::Rsc)
+        return false;
+    if (rd == 15 || (!unary && rn == 15))
+        return false;
+    if (!imm_op && (reg_op || rm == 15 || (amount == 0 && shift != Arm::Shift::Lsl)))
+        return false;
+
+    u32 value = 0;
+    if (imm_op)
+    {
+        uint rotate = bit::seq<8, 4>(instr) << 1;
+
+        value = bit::seq<0, 8>(instr);
+        if (rotate)
+        {
+            value = bit::ror(value, rotate);
+
+            if (flags && logical)
+                emit->mov(field(&arm->cpsr.c), value >> 31);
+        }
+    }
+    else
+    {
+        emit->mov(Reg::Rcx, reg(rm));
+
+        if (amount)
+        {
+            static constexpr Shift kShifts[4] = { Shift::Shl, Shift::Shr, Shift::Sar, Shift::Ror };
+
+            emit->shift(kShifts[shift], Reg::Rcx, amount);
+
+            if (flags && logical)
+                storeFlag(Cond::B, arm->cpsr.c);
+        }
+    }
+
+    auto operand = [&](Alu alu)
+    {
+        if (imm_op)
+            emit->alu(alu, Reg::Rax, value);
+        else
+            emit->alu(alu, Reg::Rax, Reg::Rcx);
+    };
+
+    auto load = [&]()
+    {
+        if (imm_op)
+            emit->mov(Reg::Rax, value);
+        else
+            emit->mov(Reg::Rax, Reg::Rcx);
+    };
+
+    switch (Opcode(opcode))
+    {
+    case Opcode::And:
+    case Opcode::Tst:
+        emit->mov(Reg::Rax, reg(rn));
+        operand(Alu::And);
+        break;
+
+    case Opcode::Eor:
+    case Opcode::Teq:
+        emit->mov(Reg::Rax, reg(rn));
+        operand(Alu::Xor);
+        break;
+
+    case Opcode::Orr:
+        emit->mov(Reg::Rax, reg(rn));
+        operand(Alu::Or);
+        break;
+
+    case Opcode::Bic:
+        if (imm_op)
+            value = ~value;
+        else
+            emit->complement(Reg::Rcx);
+        emit->mov(Reg::Rax, reg(rn));
+        operand(Alu::And);
+        break;
+
+    case Opcode::Mov:
+    case Opcode::Mvn:
+        load();
+        if (opcode == Opcode::Mvn)
+            emit->complement(Reg::Rax);
+        if (flags)
+            emit->test(Reg::Rax, Reg::Rax);
+        break;
+
+    case Opcode::Add:
+    case Opcode::Cmn:
+        emit->mov(Reg::Rax, reg(rn));
+        operand(Alu::Add);
+        break;
+
+    case Opcode::Sub:
+    case Opcode::Cmp:
+        emit->mov(Reg::Rax, reg(rn));
+        operand(Alu::Sub);
+        break;
+
+    case Opcode::Rsb:
+        load();
+        emit->alu(Alu::Sub, Reg::Rax, reg(rn));
+        break;
+
+    default:
+        SHELL_UNREACHABLE;
+        break;
+    }
+
+    if (!compare)
+        emit->mov(reg(rd), Reg::Rax);
+
+    if (flags)
+    {
+        if (logical)
+            storeFlagsNz();
+        else
+            storeFlagsNzcv(opcode != Opcode::Add && opcode != Opcode::Cmn);
+    }
+    return true;
+}
+
+bool Recompiler::emitThumb(u16 instr)
+{
+    switch (decodeThumb(hashThumb(instr)))
+    {
+    case InstructionThumb::MoveShiftedRegister:
+    {
+        static constexpr Shift kShifts[3] = { Shift::Shl, Shift::Shr, Shift::Sar };
+
+        uint rd     = bit::seq< 0, 3>(instr);
+        uint rs     = bit::seq< 3, 3>(instr);
+        uint amount = bit::seq< 6, 5>(instr);
+        uint opcode = bit::seq<11, 2>(instr);
+
+        if (amount == 0 && opcode != Arm::Shift::Lsl)
+            return false;
+
+        emit->mov(Reg::Rax, reg(rs));
+        if (amount)
+        {
+            emit->shift(kShifts[opcode], Reg::Rax, amount);
+            storeFlag(Cond::B, arm->cpsr.c);
+        }
+        else
+        {
+            emit->test(Reg::Rax, Reg::Rax);
+        }
+        emit->mov(reg(rd), Reg::Rax);
+        storeFlagsNz();
+        return true;
+    }
+
+    case InstructionThumb::AddSubtract:
+    {
+        enum class Opcode { AddReg, SubReg, AddImm, SubImm };
+
+        uint rd     = bit::seq<0, 3>(instr);
+        uint rs     = bit::seq<3, 3>(instr);
+        uint rn     = bit::seq<6, 3>(instr);
+        uint opcode = bit::seq<9, 2>(instr);
+
+        emit->mov(Reg::Rax, reg(rs));
+
+        switch (Opcode(opcode))
+        {
+        case Opcode::AddReg: emit->alu(Alu::Add, Reg::Rax, reg(rn)); break;
+        case Opcode::SubReg: emit->alu(Alu::Sub, Reg::Rax, reg(rn)); break;
+        case Opcode::AddImm: emit->alu(Alu::Add, Reg::Rax, rn); break;
+        case Opcode::SubImm: emit->alu(Alu::Sub, Reg::Rax, rn); break;
+
+        default:
+            SHELL_UNREACHABLE;
+            break;
+        }
+        emit->mov(reg(rd), Reg::Rax);
+        storeFlagsNzcv(opcode == Opcode::SubReg || opcode == Opcode::SubImm);
+        return true;
+    }
+
+    case InstructionThumb::ImmediateOperations:
+    {
+        enum class Opcode { Mov, Cmp, Add, Sub };
+
+        uint amount = bit::seq< 0, 8>(instr);
+        uint rd     = bit::seq< 8, 3>(instr);
+        uint opcode = bit::seq<11, 2>(instr);
+
+        if (opcode == Opcode::Mov)
+        {
+            emit->mov(Reg::Rax, amount);
+            emit->test(Reg::Rax, Reg::Rax);
+            emit->mov(reg(rd), Reg::Rax);
+            storeFlagsNz();
+            return true;
+        }
+
+        emit->mov(Reg::Rax, reg(rd));
+        emit->alu(opcode == Opcode::Add ? Alu::Add : Alu::Sub, Reg::Rax, amount);
+        if (opcode != Opcode::Cmp)
+            emit->mov(reg(rd), Reg::Rax);
+        storeFlagsNzcv(opcode != Opcode::Add);
+        return true;
+    }
+
+    case InstructionThumb::AluOperations:
+    {
+        enum class Opcode
+        {
+            And, Eor, Lsl, Lsr,
+            Asr, Adc, Sbc, Ror,
+            Tst, Neg, Cmp, Cmn,
+            Orr, Mul, Bic, Mvn
+        };
+
+        uint rd     = bit::seq<0, 3>(instr);
+        uint rs     = bit::seq<3, 3>(instr);
+        uint opcode = bit::seq<6, 4>(instr);
+
+        switch (Opcode(opcode))
+        {
+        case Opcode::And:
+        case Opcode::Tst:
+            emit->mov(Reg::Rax, reg(rd));
+            emit->alu(Alu::And, Reg::Rax, reg(rs));
+            break;
+
+        case Opcode::Eor:
+            emit->mov(Reg::Rax, reg(rd));
+            emit->alu(Alu::Xor, Reg::Rax, reg(rs));
+            break;
+
+        case Opcode::Orr:
+            emit->mov(Reg::Rax, reg(rd));
+            emit->alu(Alu::Or, Reg::Rax, reg(rs));
+            break;
+
+        case Opcode::Bic:
+            emit->mov(Reg::Rcx, reg(rs));
+            emit->complement(Reg::Rcx);
+            emit->mov(Reg::Rax, reg(rd));
+            emit->alu(Alu::And, Reg::Rax, Reg::Rcx);
+            break;
+
+        case Opcode::Mvn:
+            emit->mov(Reg::Rax, reg(rs));
+            emit->complement(Reg::Rax);
+            emit->test(Reg::Rax, Reg::Rax);
+            break;
+
+        case Opcode::Cmn:
+            emit->mov(Reg::Rax, reg(rd));
+            emit->alu(Alu::Add, Reg::Rax, reg(rs));
+            break;
+
+        case Opcode::Cmp:
+            emit->mov(Reg::Rax, reg(rd));
+            emit->alu(Alu::Sub, Reg::Rax, reg(rs));
+            break;
+
+        case Opcode::Neg:
+            emit->mov(Reg::Rax, 0);
+            emit->alu(Alu::Sub, Reg::Rax, reg(rs));
+            break;
+
+        default:
+            return false;
+        }
+
+        if (opcode != Opcode::Tst && opcode != Opcode::Cmn && opcode != Opcode::Cmp)
+            emit->mov(reg(rd), Reg::Rax);
+
+        if (opcode == Opcode::Cmn || opcode == Opcode::Cmp || opcode == Opcode::Neg)
+            storeFlagsNzcv(opcode != Opcode::Cmn);
+        else
+            storeFlagsNz();
+        return true;
+    }
+
+    case InstructionThumb::HighRegisterOperations:
+    {
+        enum class Opcode { Add, Cmp, Mov, Bx };
+
+        uint rd     = bit::seq<0, 3>(instr) | bit::seq<7, 1>(instr) << 3;
+        uint rs     = bit::seq<3, 3>(instr) | bit::seq<6, 1>(instr) << 3;
+        uint opcode = bit::seq<8, 2>(instr);
+
+        if (opcode == Opcode::Bx || rd == 15 || rs == 15)
+            return false;
+
+        switch (Opcode(opcode))
+        {
+        case Opcode::Add:
+            emit->mov(Reg::Rax, reg(rd));
+            emit->alu(Alu::Add, Reg::Rax, reg(rs));
+            emit->mov(reg(rd), Reg::Rax);
+            break;
+
+        case Opcode::Mov:
+            emit->mov(Reg::Rax, reg(rs));
+            emit->mov(reg(rd), Reg::Rax);
+            break;
+
+        case Opcode::Cmp:
+            emit->mov(Reg::Rax, reg(rd));
+            emit->alu(Alu::Sub, Reg::Rax, reg(rs));
+            storeFlagsNzcv(true);
+            break;
+
+        default:
+            SHELL_UNREACHABLE;
+            break;
+        }
+        return true;
+    }
+
+    default:
+        return false;
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <vector>
+
+#include "blockcache.h"
+#include "codebuffer.h"
+#include "emitter.h"
+
+// Translates cached blocks to x86-64. ALU instructions without carry input or
+// register shifts are emitted inline, everything else calls the interpreter
+// handler. Fetch cycles are accounted per instruction against the scheduler
+// and the code exits under the same conditions as the interpreted block.
+class Recompiler
+{
+public:
+    #if defined(__x86_64__) || defined(_M_X64)
+    static constexpr bool kSupported = true;
+    #else
+    static constexpr bool kSupported = false;
+    #endif
+
+    // Upper bound for the code of a single block
+    static constexpr uint kMaxCodeSize = 64 * 1024;
+
+    bool isFull() const
+    {
+        return buffer.data && buffer.capacity() < kMaxCodeSize;
+    }
+
+    void clear()
+    {
+        buffer.clear();
+    }
+
+    template<typename Opcode>
+    typename Block<Opcode>::Code compile(Arm& arm, const Block<Opcode>& block, u32 addr);
+
+private:
+    using Reg  = Emitter::Reg;
+    using Mem  = Emitter::Mem;
+    using Cond = Emitter::Cond;
+
+    static void tickRam(Arm& arm, uint cycles);
+    template<typename Opcode>
+    static void tickRom(Arm& arm);
+
+    static Mem now();
+    static Mem next();
+
+    Mem field(const void* member) const;
+    Mem reg(uint index) const;
+
+    template<typename Function>
+    void call(Function* function, u32 arg);
+    void storeFlag(Cond cond, const uint& flag);
+    void storeFlagsNz();
+    void storeFlagsNzcv(bool sub);
+
+    void emitTickRam(uint cycles);
+    template<typename Opcode>
+    void emitTickRom(u32 pc);
+    void emitCondition(uint condition, std::vector<Emitter::Label>& skip);
+    bool emitArm(u32 instr);
+    bool emitThumb(u16 instr);
+
+    Arm* arm = nullptr;
+    Emitter* emit = nullptr;
+    CodeBuffer buffer;
+};
@@ -0,0 +1,514 @@
+#include "arm.h"
+
+#include <limits>
+#include <vector>
+
+#include "base/bit.h"
+
+enum class Swi
+{
+    Div            = 0x06,
+    DivArm         = 0x07,
+    Sqrt           = 0x08,
+    ArcTan         = 0x09,
+    ArcTan2        = 0x0A,
+    CpuSet         = 0x0B,
+    CpuFastSet     = 0x0C,
+    BgAffineSet    = 0x0E,
+    ObjAffineSet   = 0x0F,
+    Lz77UnCompWram = 0x11,
+    Lz77UnCompVram = 0x12,
+    HuffUnComp     = 0x13,
+    RlUnCompWram   = 0x14,
+    RlUnCompVram   = 0x15
+};
+
+inline constexpr auto kCallCycles = 32;
+
+// BIOS sine table, sin(x * 2pi / 256) * 0x4000 truncated towards zero
+inline constexpr shell::array<s16, 256> kSine =
+{
+         0,    402,    803,   1205,   1605,   2005,   2404,   2801,
+      3196,   3589,   3980,   4369,   4756,   5139,   5519,   5896,
+      6269,   6639,   7005,   7366,   7723,   8075,   8423,   8765,
+      9102,   9434,   9759,  10079,  10393,  10701,  11002,  11297,
+     11585,  11866,  12139,  12406,  12665,  12916,  13159,  13395,
+     13622,  13842,  14053,  14255,  14449,  14634,  14810,  14978,
+     15136,  15286,  15426,  15557,  15678,  15790,  15892,  15985,
+     16069,  16142,  16206,  16260,  16305,  16339,  16364,  16379,
+     16384,  16379,  16364,  16339,  16305,  16260,  16206,  16142,
+     16069,  15985,  15892,  15790,  15678,  15557,  15426,  15286,
+     15136,  14978,  14810,  14634,  14449,  14255,  14053,  13842,
+     13622,  13395,  13159,  12916,  12665,  12406,  12139,  11866,
+     11585,  11297,  11002,  10701,  10393,  10079,   9759,   9434,
+      9102,   8765,   8423,   8075,   7723,   7366,   7005,   6639,
+      6269,   5896,   5519,   5139,   4756,   4369,   3980,   3589,
+      3196,   2801,   2404,   2005,   1605,   1205,    803,    402,
+         0,   -402,   -803,  -1205,  -1605,  -2005,  -2404,  -2801,
+     -3196,  -3589,  -3980,  -4369,  -4756,  -5139,  -5519,  -5896,
+     -6269,  -6639,  -7005,  -7366,  -7723,  -8075,  -8423,  -8765,
+     -9102,  -9434,  -9759, -10079, -10393, -10701, -11002, -11297,
+    -11585, -11866, -12139, -12406, -12665, -12916, -13159, -13395,
+    -13622, -13842, -14053, -14255, -14449, -14634, -14810, -14978,
+    -15136, -15286, -15426, -15557, -15678, -15790, -15892, -15985,
+    -16069, -16142, -16206, -16260, -16305, -16339, -16364, -16379,
+    -16384, -16379, -16364, -16339, -16305, -16260, -16206, -16142,
+    -16069, -15985, -15892, -15790, -15678, -15557, -15426, -15286,
+    -15136, -14978, -14810, -14634, -14449, -14255, -14053, -13842,
+    -13622, -13395, -13159, -12916, -12665, -12406, -12139, -11866,
+    -11585, -11297, -11002, -10701, -10393, -10079,  -9759,  -9434,
+     -9102,  -8765,  -8423,  -8075,  -7723,  -7366,  -7005,  -6639,
+     -6269,  -5896,  -5519,  -5139,  -4756,  -4369,  -3980,  -3589,
+     -3196,  -2801,  -2404,  -2005,  -1605,  -1205,   -803,   -402
+};
+
+bool isProtected(u32 addr)
+{
+    return (addr & 0x0E00'0000) == 0;
+}
+
+s32 arcTan(s32 i, s32& r1, s32& r3)
+{
+    s32 a = -((i * i) >> 14);
+    s32 b = ((0xA9 * a) >> 14) + 0x390;
+    b = ((b * a) >> 14) + 0x091C;
+    b = ((b * a) >> 14) + 0x0FB6;
+    b = ((b * a) >> 14) + 0x16AA;
+    b = ((b * a) >> 14) + 0x2081;
+    b = ((b * a) >> 14) + 0x3651;
+    b = ((b * a) >> 14) + 0xA2F9;
+
+    r1 = a;
+    r3 = b;
+
+    return (i * b) >> 16;
+}
+
+s32 arcTan2(s32 x, s32 y, s32& r1, s32& r3)
+{
+    if (y == 0)
+        return x >= 0 ? 0 : 0x8000;
+    if (x == 0)
+        return y >= 0 ? 0x4000 : 0xC000;
+
+    if (y >= 0)
+    {
+        if (x >= 0)
+        {
+            if (x >= y)
+                return arcTan((y << 14) / x, r1, r3);
+        }
+        else if (-x >= y)
+        {
+            return arcTan((y << 14) / x, r1, r3) + 0x8000;
+        }
+        return 0x4000 - arcTan((x << 14) / y, r1, r3);
+    }
+    else
+    {
+        if (x <= 0)
+        {
+            if (-x > -y)
+                return arcTan((y << 14) / x, r1, r3) + 0x8000;
+        }
+        else if (x >= -y)
+        {
+            return arcTan((y << 14) / x, r1, r3) + 0x10000;
+        }
+        return 0xC000 - arcTan((x << 14) / y, r1, r3);
+    }
+}
+
+bool Arm::swi(uint function)
+{
+    switch (Swi(function))
+    {
+    case Swi::Div:
+        if (regs[1] == 0)
+            return false;
+        swiDiv(regs[0], regs[1]);
+        break;
+
+    case Swi::DivArm:
+        if (regs[0] == 0)
+            return false;
+        swiDiv(regs[1], regs[0]);
+        break;
+
+    case Swi::Sqrt:           swiSqrt(); break;
+    case Swi::ArcTan:         swiArcTan(); break;
+    case Swi::ArcTan2:        swiArcTan2(); break;
+    case Swi::CpuSet:         swiCpuSet(); break;
+    case Swi::CpuFastSet:     swiCpuFastSet(); break;
+    case Swi::BgAffineSet:    swiBgAffineSet(); break;
+    case Swi::ObjAffineSet:   swiObjAffineSet(); break;
+    case Swi::Lz77UnCompWram: swiLz77UnComp(false); break;
+    case Swi::Lz77UnCompVram: swiLz77UnComp(true); break;
+    case Swi::HuffUnComp:
+        if (!swiHuffUnComp())
+            return false;
+        break;
+
+    case Swi::RlUnCompWram:   swiRlUnComp(false); break;
+    case Swi::RlUnCompVram:   swiRlUnComp(true); break;
+
+    default:
+        return false;
+    }
+    idle(kCallCycles);
+    return true;
+}
+
+void Arm::swiDiv(s32 number, s32 denom)
+{
+    s32 div = 0;
+    s32 mod = 0;
+    if (number == std::numeric_limits<s32>::min() && denom == -1)
+    {
+        div = number;
+        mod = 0;
+    }
+    else
+    {
+        div = number / denom;
+        mod = number % denom;
+    }
+
+    regs[0] = div;
+    regs[1] = mod;
+    regs[3] = div < 0 ? -static_cast<u32>(div) : div;
+
+    idle(40);
+}
+
+void Arm::swiSqrt()
+{
+    u32 value  = regs[0];
+    u32 result = 0;
+    u32 place  = 1 << 30;
+
+    while (place > value)
+        place >>= 2;
+
+    while (place)
+    {
+        if (value >= result + place)
+        {
+            value -= result + place;
+            result = (result >> 1) + place;
+        }
+        else
+        {
+            result >>= 1;
+        }
+        place >>= 2;
+    }
+    regs[0] = result;
+
+    idle(40);
+}
+
+void Arm::swiArcTan()
+{
+    s32 r1 = 0;
+    s32 r3 = 0;
+
+    regs[0] = arcTan(static_cast<s32>(regs[0]), r1, r3);
+    regs[1] = r1;
+    regs[3] = r3;
+
+    idle(40);
+}
+
+void Arm::swiArcTan2()
+{
+    s32 r1 = regs[1];
+    s32 r3 = regs[3];
+
+    regs[0] = static_cast<u16>(arcTan2(static_cast<s32>(regs[0]), static_cast<s32>(regs[1]), r1, r3));
+    regs[1] = r1;
+    regs[3] = r3;
+
+    idle(60);
+}
+
+void Arm::swiCpuSet()
+{
+    u32 src   = regs[0];
+    u32 dst   = regs[1];
+    u32 count = bit::seq< 0, 21>(regs[2]);
+    uint fill = bit::seq<24,  1>(regs[2]);
+    uint word = bit::seq<26,  1>(regs[2]);
+
+    if (isProtected(src))
+        return;
+
+    if (word)
+    {
+        src &= ~0x3;
+        dst &= ~0x3;
+
+        u32 value = readWord(src);
+        for (u32 x = 0; x < count; ++x)
+        {
+            if (!fill)
+                value = readWord(src + 4 * x);
+            writeWord(dst + 4 * x, value);
+        }
+    }
+    else
+    {
+        src &= ~0x1;
+        dst &= ~0x1;
+
+        u16 value = readHalf(src);
+        for (u32 x = 0; x < count; ++x)
+        {
+            if (!fill)
+                value = readHalf(src + 2 * x);
+            writeHalf(dst + 2 * x, value);
+        }
+    }
+}
+
+void Arm::swiCpuFastSet()
+{
+    u32 src   = regs[0] & ~0x3;
+    u32 dst   = regs[1] & ~0x3;
+    u32 count = (bit::seq<0, 21>(regs[2]) + 7) & ~0x7;
+    uint fill = bit::seq<24, 1>(regs[2]);
+
+    if (isProtected(src))
+        return;
+
+    u32 value = readWord(src);
+    for (u32 x = 0; x < count; ++x)
+    {
+        if (!fill)
+            value = readWord(src + 4 * x, x & 0x7 ? Access::Sequential : Access::NonSequential);
+        writeWord(dst + 4 * x, value, x & 0x7 ? Access::Sequential : Access::NonSequential);
+    }
+}
+
+void Arm::swiBgAffineSet()
+{
+    u32 src = regs[0];
+    u32 dst = regs[1];
+
+    for (u32 count = regs[2]; count--; src += 20, dst += 16)
+    {
+        s32 ox = readWord(src +  0);
+        s32 oy = readWord(src +  4);
+        s32 cx = static_cast<s16>(readHalf(src +  8));
+        s32 cy = static_cast<s16>(readHalf(src + 10));
+        s32 sx = static_cast<s16>(readHalf(src + 12));
+        s32 sy = static_cast<s16>(readHalf(src + 14));
+        uint angle = readHalf(src + 16) >> 8;
+
+        s32 sin = kSine[angle];
+        s32 cos = kSine[(angle + 64) & 0xFF];
+
+        s32 a = ( sx * cos) >> 14;
+        s32 b = (-sx * sin) >> 14;
+        s32 c = ( sy * sin) >> 14;
+        s32 d = ( sy * cos) >> 14;
+
+        writeHalf(dst +  0, a);
+        writeHalf(dst +  2, b);
+        writeHalf(dst +  4, c);
+        writeHalf(dst +  6, d);
+        writeWord(dst +  8, ox - (a * cx + b * cy));
+        writeWord(dst + 12, oy - (c * cx + d * cy));
+
+        idle(20);
+    }
+}
+
+void Arm::swiObjAffineSet()
+{
+    u32 src    = regs[0];
+    u32 dst    = regs[1];
+    u32 offset = regs[3];
+
+    for (u32 count = regs[2]; count--; src += 8, dst += 4 * offset)
+    {
+        s32 sx = static_cast<s16>(readHalf(src + 0));
+        s32 sy = static_cast<s16>(readHalf(src + 2));
+        uint angle = readHalf(src + 4) >> 8;
+
+        s32 sin = kSine[angle];
+        s32 cos = kSine[(angle + 64) & 0xFF];
+
+        writeHalf(dst + 0 * offset, ( sx * cos) >> 14);
+        writeHalf(dst + 1 * offset, (-sx * sin) >> 14);
+        writeHalf(dst + 2 * offset, ( sy * sin) >> 14);
+        writeHalf(dst + 3 * offset, ( sy * cos) >> 14);
+
+        idle(16);
+    }
+}
+
+void Arm::swiLz77UnComp(bool vram)
+{
+    u32 src = regs[0];
+    u32 dst = regs[1];
+
+    if (isProtected(src))
+        return;
+
+    u32 size = readWord(src) >> 8;
+    src += 4;
+
+    std::vector<u8> data;
+    data.reserve(size);
+
+    while (data.size() < size)
+    {
+        uint flags = readByte(src++);
+
+        for (uint x = 0; x < 8 && data.size() < size; ++x, flags <<= 1)
+        {
+            if (flags & 0x80)
+            {
+                uint byte1 = readByte(src++);
+                uint byte2 = readByte(src++);
+
+                uint disp   = (bit::seq<0, 4>(byte1) << 8 | byte2) + 1;
+                uint length = bit::seq<4, 4>(byte1) + 3;
+
+                for (; length-- && data.size() < size; )
+                {
+                    if (disp <= data.size())
+                        data.push_back(data[data.size() - disp]);
+                    else
+                        data.push_back(readByte(dst + data.size() - disp));
+                }
+            }
+            else
+            {
+                data.push_back(readByte(src++));
+            }
+        }
+    }
+    swiWrite(dst, data, vram);
+}
+
+bool Arm::swiHuffUnComp()
+{
+    u32 src = regs[0] & ~0x3;
+    u32 dst = regs[1] & ~0x3;
+
+    if (isProtected(src))
+        return true;
+
+    u32 header = readWord(src);
+    uint bits = bit::seq<0, 4>(header);
+    u32  size = header >> 8;
+
+    if (bits != 1 && bits != 2 && bits != 4 && bits != 8)
+        return false;
+
+    u32 tree   = src + 4;
+    u32 root   = tree + 1;
+    u32 stream = tree + 2 * (readByte(tree) + 1);
+
+    u32 node_addr = root;
+    uint node = readByte(root);
+
+    u32 buffer = 0;
+    uint shift = 0;
+
+    while (size > 0)
+    {
+        u32 word = readWord(stream);
+        stream += 4;
+
+        for (int x = 31; x >= 0 && size > 0; --x)
+        {
+            uint dir = (word >> x) & 0x1;
+            u32 next = (node_addr & ~0x1) + 2 * bit::seq<0, 6>(node) + 2 + dir;
+
+            if (node & (0x80 >> dir))
+            {
+                buffer |= (readByte(next) & ((1 << bits) - 1)) << shift;
+                shift += bits;
+
+                if (shift == 32)
+                {
+                    writeWord(dst, buffer);
+                    dst += 4;
+                    size = size > 4 ? size - 4 : 0;
+
+                    buffer = 0;
+                    shift  = 0;
+                }
+                node_addr = root;
+                node = readByte(root);
+            }
+            else
+            {
+                node_addr = next;
+                node = readByte(next);
+            }
+        }
+    }
+    return true;
+}
+
+void Arm::swiRlUnComp(bool vram)
+{
+    u32 src = regs[0];
+    u32 dst = regs[1];
+
+    if (isProtected(src))
+        return;
+
+    u32 size = readWord(src) >> 8;
+    src += 4;
+
+    std::vector<u8> data;
+    data.reserve(size);
+
+    while (data.size() < size)
+    {
+        uint flags = readByte(src++);
+
+        if (flags & 0x80)
+        {
+            u8 byte = readByte(src++);
+            for (uint length = bit::seq<0, 7>(flags) + 3; length-- && data.size() < size; )
+                data.push_back(byte);
+        }
+        else
+        {
+            for (uint length = bit::seq<0, 7>(flags) + 1; length-- && data.size() < size; )
+                data.push_back(readByte(src++));
+        }
+    }
+    swiWrite(dst, data, vram);
+}
+
+void Arm::swiWrite(u32 dst, const std::vector<u8>& data, bool vram)
+{
+    if (vram)
+    {
+        for (std::size_t x = 0; x < data.size(); x += 2)
+        {
+            // Keep the byte after an odd sized output intact
+            u16 half = data[x];
+            if (x + 1 < data.size())
+                half |= data[x + 1] << 8;
+            else
+                half |= readByte(dst + x + 1) << 8;
+
+            writeHalf(dst + x, half, x ? Access::Sequential : Access::NonSequential);
+        }
+    }
+    else
+    {
+        for (std::size_t x = 0; x < data.size(); ++x)
+        {
+            writeByte(dst + x, data[x], x ? Access::Sequential : Access::NonSequential);
+        }
+    }
+}
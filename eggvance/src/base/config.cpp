@@ -103,7 +103,11 @@ Config::~Config()
     set("settings",   "save_path",             fmt::to_string(save_path));
     set("settings",   "bios_file",             fmt::to_string(bios_file));
     set("settings",   "bios_skip",             fmt::to_string(bios_skip));
+    set("settings",   "bios_hle",              fmt::to_string(bios_hle));
     set("emulation",  "fast_forward",          fmt::to_string(fast_forward));
+    set("emulation",  "block_cache",           fmt::to_string(block_cache));
+    set("emulation",  "recompiler",            fmt::to_string(recompiler));
+    set("emulation",  "render_thread",         fmt::to_string(render_thread));
     set("video",      "frame_size",            fmt::to_string(frame_size));
     set("video",      "color_correct",         fmt::to_string(color_correct));
     set("video",      "preserve_aspect_ratio", fmt::to_string(preserve_aspect_ratio));
@@ -145,7 +149,11 @@ void Config::init()
     save_path             = findOr("settings",   "save_path",             fs::path());
     bios_file             = findOr("settings",   "bios_file",             fs::path());
     bios_skip             = findOr("settings",   "bios_skip",             true);
+    bios_hle              = findOr("settings",   "bios_hle",              false);
     fast_forward          = findOr("emulation",  "fast_forward",          1'000'000);
+    block_cache           = findOr("emulation",  "block_cache",           false);
+    recompiler            = findOr("emulation",  "recompiler",            false);
+    render_thread         = findOr("emulation",  "render_thread",         false);
     frame_size            = findOr("video",      "frame_size",            4);
     color_correct         = findOr("video",      "color_correct",         true);
     preserve_aspect_ratio = findOr("video",      "preserve_aspect_ratio", true);
@@ -76,8 +76,12 @@ class Config : public Ini
     fs::path    save_path;
     fs::path    bios_file;
     bool        bios_skip;
+    bool        bios_hle;
     RecentFiles recent;
     uint        fast_forward;
+    bool        block_cache;
+    bool        recompiler;
+    bool        render_thread;
     uint        frame_size;
     bool        color_correct;
     bool        preserve_aspect_ratio;
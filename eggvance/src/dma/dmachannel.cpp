@@ -1,10 +1,32 @@
 #include "dmachannel.h"
 
+#include <algorithm>
+#include <type_traits>
+
 #include "apu/apu.h"
 #include "arm/arm.h"
+#include "base/bit.h"
 #include "gamepak/eeprom.h"
 #include "gamepak/gamepak.h"
 #include "ppu/ppu.h"
+#include "timer/timer.h"
+
+inline constexpr int kSadDeltas[4] = { 1, -1, 0, 0 };
+inline constexpr int kDadDeltas[4] = { 1, -1, 0, 1 };
+
+template<typename Memory>
+void store(Memory& memory, u32 addr, u16 half)
+{
+    ppu.sync();
+    memory.writeHalf(addr, half);
+}
+
+template<typename Memory>
+void store(Memory& memory, u32 addr, u32 word)
+{
+    ppu.sync();
+    memory.writeWord(addr, word);
+}
 
 DmaChannel::DmaChannel(uint id)
     : id(id), sad(id), dad(id), count(id), control(*this)
@@ -49,7 +71,11 @@ bool DmaChannel::start()
 {
     if (latch.fifo)
     {
-        if (apu.fifos[latch.dad.isFifoB()].size() > 16)
+        const auto& fifo = apu.fifos[latch.dad.isFifoB()];
+
+        timer.channels[fifo.timer].sync();
+
+        if (fifo.size() > 16)
             return false;
     }
     else if (control.repeat)
@@ -68,29 +94,8 @@ bool DmaChannel::start()
 
 void DmaChannel::run()
 {
-    static constexpr int kSadDeltas[2][4] = { { 2, -2, 0, 0 }, { 4, -4, 0, 0 } };
-    static constexpr int kDadDeltas[2][4] = { { 2, -2, 0, 2 }, { 4, -4, 0, 4 } };
-
-    while (pending--)
-    {
-        if (pending == latch.count - 1)
-        {
-            if (!(latch.sad.isGamePak() && latch.dad.isGamePak()))
-                arm.idle(2);
-
-            transfer(Access::NonSequential);
-        }
-        else
-        {
-            transfer(Access::Sequential);
-        }
-
-        latch.sad = latch.sad + kSadDeltas[latch.word][latch.sadcnt];
-        latch.dad = latch.dad + kDadDeltas[latch.word][latch.dadcnt];
-
-        if (pending && arm.target >= scheduler.now)
-            return;
-    }
+    if (!kernel(*this))
+        return;
 
     running = false;
 
@@ -129,63 +134,249 @@ void DmaChannel::initEeprom()
 
 void DmaChannel::initTransfer()
 {
-    bool eeprom_r = gamepak.isEepromAccess(latch.sad);
-    bool eeprom_w = gamepak.isEepromAccess(latch.dad);
+    Target target = Target::Normal;
 
-    if ((eeprom_r || eeprom_w) && id == 3)
+    if (id == 3)
     {
-        initEeprom();
+        if (gamepak.isEepromAccess(latch.sad))
+            target = Target::EepromRead;
+        else if (gamepak.isEepromAccess(latch.dad))
+            target = Target::EepromWrite;
+
+        if (target != Target::Normal)
+            initEeprom();
+    }
 
-        if (eeprom_r)
+    kernel = kernels[uint(target) << 5 | latch.word << 4 | latch.sadcnt << 2 | latch.dadcnt];
+}
+
+template<uint kHash>
+bool DmaChannel::transfer()
+{
+    constexpr uint kDadcnt = bit::seq<0, 2>(kHash);
+    constexpr uint kSadcnt = bit::seq<2, 2>(kHash);
+    constexpr uint kWord   = bit::seq<4, 1>(kHash);
+    constexpr uint kTarget = bit::seq<5, 2>(kHash);
+
+    using Integral = std::conditional_t<kWord, u32, u16>;
+
+    constexpr int kSadDelta = kSadDeltas[kSadcnt] * int(sizeof(Integral));
+    constexpr int kDadDelta = kDadDeltas[kDadcnt] * int(sizeof(Integral));
+
+    if constexpr (kTarget != uint(Target::Normal) && kWord == 0)
+    {
+        if (pending == latch.count && transaction<kSadDelta, kDadDelta, Target(kTarget)>())
+            return true;
+    }
+
+    while (pending)
+    {
+        uint units = 1;
+
+        if (pending == latch.count)
         {
-            transfer = [this](Access access)
-            {
-                if (latch.sad < 0x200'0000)
-                    arm.idle();
-                else
-                    bus = gamepak.save->read(latch.sad);
-                
-                arm.writeHalf(latch.dad, bus, access);
-            };
+            if (!(latch.sad.isGamePak() && latch.dad.isGamePak()))
+                arm.idle(2);
+
+            transferUnit<Integral, Target(kTarget)>(Access::NonSequential);
         }
-        else
+        else if (!(units = burst<Integral, kSadcnt, kDadcnt, Target(kTarget)>()))
         {
-            transfer = [this](Access access)
-            {
-                if (latch.sad < 0x200'0000) 
-                    arm.idle();
-                else
-                    bus = arm.readHalf(latch.sad, access) * 0x0001'0001;
-
-                gamepak.save->write(latch.dad, bus);
-            };
+            units = 1;
+            transferUnit<Integral, Target(kTarget)>(Access::Sequential);
         }
+
+        pending  -= units;
+        latch.sad = latch.sad + units * kSadDelta;
+        latch.dad = latch.dad + units * kDadDelta;
+
+        if (pending && arm.target >= scheduler.now)
+            return false;
     }
+    return true;
+}
+
+template<typename Integral, DmaChannel::Target kTarget>
+void DmaChannel::transferUnit(Access access)
+{
+    constexpr bool kWord = std::is_same_v<Integral, u32>;
+
+    if (latch.sad < 0x200'0000)
+        arm.idle();
+    else if constexpr (kTarget == Target::EepromRead)
+        bus = gamepak.save->read(latch.sad);
+    else if constexpr (kWord && kTarget == Target::Normal)
+        bus = arm.readWord(latch.sad, access);
+    else
+        bus = arm.readHalf(latch.sad, access) * 0x0001'0001;
+
+    if constexpr (kTarget == Target::EepromWrite)
+        gamepak.save->write(latch.dad, bus);
+    else if constexpr (kWord && kTarget == Target::Normal)
+        arm.writeWord(latch.dad, bus, access);
     else
+        arm.writeHalf(latch.dad, bus, access);
+}
+
+template<typename Integral, uint kSadcnt, uint kDadcnt, DmaChannel::Target kTarget>
+uint DmaChannel::burst()
+{
+    if constexpr (kTarget != Target::Normal
+            || kSadcnt == uint(DmaControl::Control::Decrement)
+            || kSadcnt == uint(DmaControl::Control::Reload)
+            || kDadcnt == uint(DmaControl::Control::Decrement))
+        return 0;
+
+    if (latch.sad < 0x200'0000 || latch.dad >= 0x800'0000)
+        return 0;
+
+    const Page* src = arm.pages.find(latch.sad);
+    Page* dst = arm.pages.find(latch.dad);
+
+    if (!src || !dst)
+        return 0;
+
+    constexpr bool kWord = std::is_same_v<Integral, u32>;
+
+    u64 cycles = kWord ? dst->wait_word : dst->wait_half;
+    if (src->wait_half)
+        cycles += kWord ? src->wait_word : src->wait_half;
+    else
+        cycles += kWord
+            ? arm.waitcnt.waitWord(latch.sad, Access::Sequential)
+            : arm.waitcnt.waitHalf(latch.sad, Access::Sequential);
+
+    // Stop strictly before anything else could observe the transfer
+    u64 limit = std::min(scheduler.next, arm.target);
+    if (limit <= scheduler.now + 1)
+        return 0;
+
+    auto remaining = [](u32 addr)
     {
-        if (latch.word)
+        return (PageTable::kPageSize - (addr & (PageTable::kPageSize - 1))) / sizeof(Integral);
+    };
+
+    u64 units = std::min<u64>(pending, (limit - scheduler.now - 1) / cycles);
+    if (kSadcnt == uint(DmaControl::Control::Increment))
+        units = std::min<u64>(units, remaining(latch.sad));
+    if (kDadcnt != uint(DmaControl::Control::Fixed))
+        units = std::min<u64>(units, remaining(latch.dad));
+
+    if (units == 0)
+        return 0;
+
+    u32 sad = latch.sad;
+    u32 dad = latch.dad;
+
+    auto copy = [&](auto write)
+    {
+        Integral value = 0;
+        for (uint x = 0; x < units; ++x)
         {
-            transfer = [this](Access access)
-            {
-                if (latch.sad < 0x200'0000)
-                    arm.idle();
-                else
-                    bus = arm.readWord(latch.sad, access);
-                
-                arm.writeWord(latch.dad, bus, access);
-            };
+            value = src->template read<Integral>(sad);
+            write(dad, value);
+            sad += kSadDeltas[kSadcnt] * int(sizeof(Integral));
+            dad += kDadDeltas[kDadcnt] * int(sizeof(Integral));
         }
-        else
+        return value;
+    };
+
+    Integral value = 0;
+    switch (latch.dad >> 24)
+    {
+    case 0x5: value = copy([](u32 addr, Integral value) { store(ppu.pram, addr, value); }); break;
+    case 0x6: value = copy([](u32 addr, Integral value) { store(ppu.vram, addr, value); }); break;
+    case 0x7: value = copy([](u32 addr, Integral value) { store(ppu.oam,  addr, value); }); break;
+
+    default:
+        arm.blocks.invalidate(latch.dad, units * sizeof(Integral));
+        value = copy([dst](u32 addr, Integral value) { dst->write(addr, value); });
+        break;
+    }
+
+    bus = kWord ? value : value * 0x0001'0001;
+
+    arm.idle(units * cycles);
+
+    return units;
+}
+
+template<int kSadDelta, int kDadDelta, DmaChannel::Target kTarget>
+bool DmaChannel::transaction()
+{
+    constexpr auto kMaxBits = 81;
+
+    // Complete EEPROM commands are moved between RAM and the EEPROM in one step
+    constexpr bool kWrite = kTarget == Target::EepromWrite;
+    constexpr int kDelta = kWrite ? kSadDelta : kDadDelta;
+
+    if (kDelta != 2 || latch.count > kMaxBits)
+        return false;
+
+    u32 addr = kWrite ? latch.sad : latch.dad;
+    if (addr < 0x200'0000 || (addr & (PageTable::kPageSize - 1)) + 2 * latch.count > PageTable::kPageSize)
+        return false;
+
+    Page* page = arm.pages.find(addr);
+    if (!page || !(kWrite || page->writable))
+        return false;
+
+    Eeprom& eeprom = static_cast<Eeprom&>(*gamepak.save);
+    shell::array<u8, kMaxBits> bits;
+
+    u64 cycles = 0;
+    if (!(latch.sad.isGamePak() && latch.dad.isGamePak()))
+        cycles += 2;
+
+    if constexpr (kWrite)
+    {
+        u16 half = 0;
+        for (uint x = 0; x < latch.count; ++x)
         {
-            transfer = [this](Access access)
-            {
-                if (latch.sad < 0x200'0000)
-                    arm.idle();
-                else
-                    bus = arm.readHalf(latch.sad, access) * 0x0001'0001;
-
-                arm.writeHalf(latch.dad, bus, access);
-            };
+            half = page->read<u16>(addr + 2 * x);
+            bits[x] = half;
         }
+        eeprom.writeBits(bits.data(), latch.count);
+
+        bus = half * 0x0001'0001;
+
+        if (page->wait_half)
+            cycles += latch.count * page->wait_half;
+        else
+            cycles += arm.waitcnt.waitHalf(addr, Access::NonSequential)
+                + arm.waitcnt.waitHalf(addr, Access::Sequential) * (latch.count - 1);
+    }
+    else
+    {
+        eeprom.readBits(bits.data(), latch.count);
+
+        for (uint x = 0; x < latch.count; ++x)
+            page->write<u16>(addr + 2 * x, bits[x]);
+
+        arm.blocks.invalidate(addr, 2 * latch.count);
+
+        bus = bits[latch.count - 1];
+
+        cycles += latch.count * page->wait_half;
     }
+
+    arm.idle(cycles);
+
+    latch.sad = latch.sad + latch.count * kSadDelta;
+    latch.dad = latch.dad + latch.count * kDadDelta;
+    pending = 0;
+
+    return true;
 }
+
+#define KERNEL001(hash) &DmaChannel::invoke<hash>,
+#define KERNEL004(hash) KERNEL001(hash + 0 *  1) KERNEL001(hash + 1 *  1) KERNEL001(hash + 2 *  1) KERNEL001(hash + 3 *  1)
+#define KERNEL016(hash) KERNEL004(hash + 0 *  4) KERNEL004(hash + 1 *  4) KERNEL004(hash + 2 *  4) KERNEL004(hash + 3 *  4)
+#define KERNEL096(hash) KERNEL016(hash + 0 * 16) KERNEL016(hash + 1 * 16) KERNEL016(hash + 2 * 16) KERNEL016(hash + 3 * 16) KERNEL016(hash + 4 * 16) KERNEL016(hash + 5 * 16)
+
+const std::array<DmaChannel::Kernel, 96> DmaChannel::kernels = { KERNEL096(0) };
+
+#undef KERNEL001
+#undef KERNEL004
+#undef KERNEL016
+#undef KERNEL096
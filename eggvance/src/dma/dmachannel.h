@@ -1,10 +1,11 @@
 #pragma once
 
-#include <functional>
+#include <array>
 
 #include "dmaaddress.h"
 #include "io.h"
 #include "arm/constants.h"
+#include "arm/pagetable.h"
 
 class DmaChannel
 {
@@ -24,9 +25,30 @@ class DmaChannel
     DmaControl control;
 
 private:
+    enum class Target { Normal, EepromRead, EepromWrite };
+
+    using Kernel = bool(*)(DmaChannel&);
+
+    static const std::array<Kernel, 96> kernels;
+
+    template<uint kHash>
+    static bool invoke(DmaChannel& channel)
+    {
+        return channel.transfer<kHash>();
+    }
+
     void initEeprom();
     void initTransfer();
 
+    template<uint kHash>
+    bool transfer();
+    template<typename Integral, Target kTarget>
+    void transferUnit(Access access);
+    template<typename Integral, uint kSadcnt, uint kDadcnt, Target kTarget>
+    uint burst();
+    template<int kSadDelta, int kDadDelta, Target kTarget>
+    bool transaction();
+
     uint running = 0;
     uint pending = 0;
     uint bus     = 0;
@@ -42,5 +64,5 @@ class DmaChannel
         DmaAddress dad;
     } latch;
 
-    std::function<void(Access)> transfer;
+    Kernel kernel = nullptr;
 };
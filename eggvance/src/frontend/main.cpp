@@ -479,6 +479,18 @@ float doUi()
                 }
                 ImGui::EndMenu();
             }
+
+            ImGui::Separator();
+
+            if (ImGui::MenuItem("Block cache", nullptr, config.block_cache))
+                config.block_cache ^= true;
+
+            if (ImGui::MenuItem("Recompiler", nullptr, config.recompiler, config.block_cache && Recompiler::kSupported))
+                config.recompiler ^= true;
+
+            if (ImGui::MenuItem("Render thread", nullptr, config.render_thread))
+                config.render_thread ^= true;
+
             ImGui::EndMenu();
         }
 
@@ -515,6 +527,7 @@ float doUi()
             {
                 config.color_correct ^= true;
                 Color::init(config.color_correct);
+                ppu.pram.convert();
             }
 
             if (ImGui::MenuItem("Preserve aspect ratio", nullptr, config.preserve_aspect_ratio))
@@ -633,6 +646,13 @@ float doUi()
         ImGui::SettingsLabel("Skip BIOS");
         ImGui::Checkbox("", &config.bios_skip);
 
+        ImGui::PushID("HLE");
+        {
+            ImGui::SettingsLabel("HLE BIOS calls");
+            ImGui::Checkbox("", &config.bios_hle);
+        }
+        ImGui::PopID();
+
         ImGui::EndSettingsWindow();
     }
 
@@ -756,6 +776,7 @@ void frame(State state)
 
         keypad.update();
         arm.run(kFrameCycles);
+        ppu.sync();
     }
     else
     {
@@ -119,6 +119,67 @@ void Eeprom::write(u32 addr, u8 byte)
     }
 }
 
+void Eeprom::readBits(u8* bits, uint count)
+{
+    if (state == State::ReadUnused && buffer.size == 0 && count == 4 + 64)
+    {
+        u64 value = address < data.size()
+            ? *reinterpret_cast<u64*>(data.data() + address)
+            : std::numeric_limits<u64>::max();
+
+        for (uint x = 0; x < 4; ++x)
+            bits[x] = 1;
+
+        for (uint x = 0; x < 64; ++x)
+            bits[4 + x] = (value >> (63 - x)) & 0x1;
+
+        setState(State::Receive);
+        return;
+    }
+
+    for (uint x = 0; x < count; ++x)
+        bits[x] = read(0);
+}
+
+void Eeprom::writeBits(const u8* bits, uint count)
+{
+    if (state == State::Receive && buffer.size == 0 && isInitialized())
+    {
+        auto parse = [bits](uint begin, uint size)
+        {
+            u64 value = 0;
+            for (uint x = begin; x < begin + size; ++x)
+                value = (value << 1) | (bits[x] & 0x1);
+            return value;
+        };
+
+        uint bus = this->bus();
+        uint command = parse(0, 2);
+
+        if (command == 0b10 && count == 2 + bus + 64 + 1)
+        {
+            address = parse(2, bus) << 3;
+            if (address < data.size())
+            {
+                changed = true;
+                *reinterpret_cast<u64*>(data.data() + address) = parse(2 + bus, 64);
+            }
+            setState(State::Receive);
+            return;
+        }
+
+        if (command == 0b11 && count == 2 + bus + 1)
+        {
+            address = parse(2, bus) << 3;
+            setState(State::ReadUnused);
+            return;
+        }
+    }
+
+    for (uint x = 0; x < count; ++x)
+        write(0, bits[x]);
+}
+
 bool Eeprom::isValidSize(uint size) const
 {
     return size == kSize512Bytes
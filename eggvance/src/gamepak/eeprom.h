@@ -16,6 +16,9 @@ class Eeprom final : public Save
     u8 read(u32 addr) final;
     void write(u32 addr, u8 byte) final;
 
+    void readBits(u8* bits, uint count);
+    void writeBits(const u8* bits, uint count);
+
 protected:
     bool isValidSize(uint size) const final;
 
@@ -12,6 +12,22 @@ class Color
     static void init(bool color_correct);
     static uint toArgb(u16 color);
 
+    static constexpr u32 kSpreadMask = 0x03E0'7C1F;
+
+    // Moves green to bits 21-25 so that every channel has room for a
+    // blend product of up to 10 bits
+    static constexpr u32 spread(u16 color)
+    {
+        return (color | (u32(color) << 16)) & kSpreadMask;
+    }
+
+    static constexpr u16 pack(u32 color)
+    {
+        color &= kSpreadMask;
+
+        return (color | (color >> 16)) & 0x7FFF;
+    }
+
 private:
     inline static shell::array<u32, 0x8000> lut = {};
 };
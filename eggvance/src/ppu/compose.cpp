@@ -1,324 +1,235 @@
 #include "ppu.h"
 
+#include <algorithm>
 #include <shell/macros.h>
 #include <shell/operators.h>
 
-#include "color.h"
 #include "base/config.h"
 #include "frontend/videocontext.h"
 
 void Ppu::compose(uint possible)
 {
-    BackgroundLayers layers;
-
-    for (uint background : bit::iterate(possible & dispcnt.enabled & config.video_layers))
-    {
-        layers.push_back({
-            backgrounds[background].control.priority,
-            backgrounds[background].buffer.data(),
-            backgrounds[background].flag() });
-    }
-
-    std::sort(layers.begin(), layers.end());
+    uint enabled = 0xFF;
 
     if (dispcnt.win0 || dispcnt.win1 || dispcnt.winobj)
     {
         uint windows = 0;
 
-        if (dispcnt.win0 && winv[0].contains(vcount))
+        if (dispcnt.win0 && winv[0].contains(line))
             windows |= Window::Flag::Win0;
 
-        if (dispcnt.win1 && winv[1].contains(vcount))
+        if (dispcnt.win1 && winv[1].contains(line))
             windows |= Window::Flag::Win1;
 
         if (dispcnt.winobj && objects_exist)
             windows |= Window::Flag::WinObj;
 
-        if (bldcnt.mode != BlendMode::Disabled || objects_alpha)
-        {
-            switch (objects_exist | (bldcnt.mode << 1) | (windows << 3))
-            {
-            SHELL_CASE64(0,
-                composeBW<
-                    bit::seq<0, 1>(kLabel),
-                    bit::seq<1, 2>(kLabel),
-                    bit::seq<3, 3>(kLabel)>(layers))
-
-            default:
-                SHELL_UNREACHABLE;
-                break;
-            }
-        }
-        else
-        {
-            switch (objects_exist | (windows << 1))
-            {
-            SHELL_CASE16(0,
-                composeNW<
-                    bit::seq<0, 1>(kLabel),
-                    bit::seq<1, 3>(kLabel)>(layers))
-
-            default:
-                SHELL_UNREACHABLE;
-                break;
-            }
-        }
+        enabled = composeWindows(windows);
     }
     else
     {
-        if (bldcnt.mode != BlendMode::Disabled || objects_alpha)
+        composite.enabled.fill(0xFF);
+        composite.blend.fill(1);
+    }
+
+    BackgroundLayers layers;
+
+    for (uint background : bit::iterate(possible & dispcnt.enabled & config.video_layers & enabled))
+    {
+        layers.push_back({
+            backgrounds[background].control.priority,
+            backgrounds[background].buffer.data(),
+            backgrounds[background].flag() });
+    }
+
+    std::sort(layers.begin(), layers.end());
+
+    uint objects_used  = objects_exist && (enabled & uint(Layer::Flag::Obj));
+    uint objects_blend = objects_alpha && objects_used;
+
+    if (bldcnt.mode != BlendMode::Disabled || objects_blend)
+    {
+        switch (objects_used | (bldcnt.mode << 1))
         {
-            switch (objects_exist | (bldcnt.mode << 1))
-            {
-            SHELL_CASE08(0,
-                composeBN<
-                    bit::seq<0, 1>(kLabel),
-                    bit::seq<1, 2>(kLabel)>(layers))
-
-            default:
-                SHELL_UNREACHABLE;
-                break;
-            }
+        SHELL_CASE08(0,
+            composeB<
+                bit::seq<0, 1>(kLabel),
+                bit::seq<1, 2>(kLabel)>(layers))
+
+        default:
+            SHELL_UNREACHABLE;
+            break;
         }
-        else
+    }
+    else
+    {
+        switch (objects_used)
         {
-            switch (objects_exist)
-            {
-            SHELL_CASE02(0,
-                composeNN<
-                    bit::seq<0, 1>(kLabel)>(layers))
+        SHELL_CASE02(0,
+            composeN<
+                bit::seq<0, 1>(kLabel)>(layers))
 
-            default:
-                SHELL_UNREACHABLE;
-                break;
-            }
+        default:
+            SHELL_UNREACHABLE;
+            break;
         }
     }
 }
 
-template<bool kObjects>
-void Ppu::composeNN(const BackgroundLayers& layers)
+// Resolves the windows of the line into per-pixel masks, filling whole
+// ranges from the lowest to the highest priority window. Returns the
+// layers enabled anywhere on the line.
+uint Ppu::composeWindows(uint windows)
 {
-    for (auto [x, color] : shell::enumerate(video_ctx.scanline(vcount)))
+    auto fill = [this](uint begin, uint end, const Window& window)
     {
-        color = Color::toArgb(findUpperLayer<kObjects>(layers, x, 0xFFFF'FFFF).color);
-    }
-}
+        std::fill(composite.enabled.begin() + begin, composite.enabled.begin() + end, window.enabled);
+        std::fill(composite.blend.begin()   + begin, composite.blend.begin()   + end, window.blend);
 
-template<bool kObjects, uint kWindows>
-void Ppu::composeNW(const BackgroundLayers& layers)
-{
-    for (auto [x, color] : shell::enumerate(video_ctx.scanline(vcount)))
-    {
-        const auto& window = activeWindow<kWindows>(x);
+        return begin < end ? window.enabled : 0;
+    };
 
-        color = Color::toArgb(findUpperLayer<kObjects>(layers, x, window.enabled).color);
-    }
-}
+    uint enabled = fill(0, kScreenW, winout.winout);
 
-template<bool kObjects, uint kBlendMode>
-void Ppu::composeBN(const BackgroundLayers& layers)
-{
-    for (auto [x, color] : shell::enumerate(video_ctx.scanline(vcount)))
+    if (windows & Window::Flag::WinObj)
     {
-        ComposeLayer upper;
-        ComposeLayer lower;
+        const auto& window = winout.winobj;
 
-        bool alpha_object = kObjects && objects[x].alpha;
-        if ( alpha_object)
+        for (uint x = 0; x < kScreenW; ++x)
         {
-            std::tie(upper, lower) = findUpperLayers<kObjects>(layers, x);
-
-            if (upper.flag == Layer::Flag::Obj && (bldcnt.lower & lower.flag))
+            if (objects[x].window)
             {
-                color = Color::toArgb(bldalpha.blendAlpha(upper.color, lower.color));
-                continue;
+                composite.enabled[x] = window.enabled;
+                composite.blend[x]   = window.blend;
             }
         }
+        enabled |= window.enabled;
+    }
 
-        switch (BlendMode(kBlendMode))
-        {
-        case BlendMode::Alpha:
-            if (!alpha_object)
-                std::tie(upper, lower) = findUpperLayers<kObjects>(layers, x);
-
-            if ((bldcnt.upper & upper.flag) && (bldcnt.lower & lower.flag))
-                upper.color = bldalpha.blendAlpha(upper.color, lower.color);
-            break;
-
-        case BlendMode::White:
-            if (!alpha_object)
-                upper = findUpperLayer<kObjects>(layers, x);
+    if (windows & Window::Flag::Win1)
+        enabled |= fill(winh[1].begin(), winh[1].end(), winin.win1);
 
-            if (bldcnt.upper & upper.flag)
-                upper.color = bldfade.blendWhite(upper.color);
-            break;
+    if (windows & Window::Flag::Win0)
+        enabled |= fill(winh[0].begin(), winh[0].end(), winin.win0);
 
-        case BlendMode::Black:
-            if (!alpha_object)
-                upper = findUpperLayer<kObjects>(layers, x);
+    return enabled;
+}
 
-            if (bldcnt.upper & upper.flag)
-                upper.color = bldfade.blendBlack(upper.color);
-            break;
+// Resolves the two topmost layers of every pixel one layer at a time. The
+// branchless selects over contiguous buffers are left to the vectoriser.
+template<bool kObjects, bool kLower>
+void Ppu::composeLayers(const BackgroundLayers& layers)
+{
+    auto& c = composite;
 
-        case BlendMode::Disabled:
-            if (!alpha_object)
-                upper = findUpperLayer<kObjects>(layers, x);
-            break;
+    c.upper.fill(pram.backdrop());
+    c.upper_flag.fill(uint(Layer::Flag::Bdp));
+    c.upper_priority.fill(4);
 
-        default:
-            SHELL_UNREACHABLE;
-            break;
-        }
-        color = Color::toArgb(upper.color);
+    if (kLower)
+    {
+        c.lower.fill(pram.backdrop());
+        c.lower_flag.fill(uint(Layer::Flag::Bdp));
+        c.lower_priority.fill(4);
     }
-}
 
-template<bool kObjects, uint kBlendMode, uint kWindows>
-void Ppu::composeBW(const BackgroundLayers& layers)
-{
-    for (auto [x, color] : shell::enumerate(video_ctx.scanline(vcount)))
+    for (auto layer = layers.end(); layer-- != layers.begin(); )
     {
-        const auto& window = activeWindow<kWindows>(x);
+        const u16* data = layer->data;
+        const u8 flag = layer->flag;
+        const u8 priority = layer->priority;
 
-        ComposeLayer upper;
-        ComposeLayer lower;
-
-        bool alpha_object = kObjects && objects[x].alpha;
-        if ( alpha_object)
+        for (uint x = 0; x < kScreenW; ++x)
         {
-            std::tie(upper, lower) = findUpperLayers<kObjects>(layers, x, window.enabled);
-
-            if (upper.flag == Layer::Flag::Obj && (bldcnt.lower & lower.flag))
-            {
-                color = Color::toArgb(bldalpha.blendAlpha(upper.color, lower.color));
-                continue;
-            }
-        }
+            bool visible = data[x] != kTransparent && (c.enabled[x] & flag);
 
-        if (window.blend)
-        {
-            switch (BlendMode(kBlendMode))
+            if (kLower)
             {
-            case BlendMode::Alpha:
-                if (!alpha_object)
-                    std::tie(upper, lower) = findUpperLayers<kObjects>(layers, x, window.enabled);
-
-                if ((bldcnt.upper & upper.flag) && (bldcnt.lower & lower.flag))
-                    upper.color = bldalpha.blendAlpha(upper.color, lower.color);
-                break;
-
-            case BlendMode::White:
-                if (!alpha_object)
-                    upper = findUpperLayer<kObjects>(layers, x, window.enabled);
-
-                if (bldcnt.upper & upper.flag)
-                    upper.color = bldfade.blendWhite(upper.color);
-                break;
-
-            case BlendMode::Black:
-                if (!alpha_object)
-                    upper = findUpperLayer<kObjects>(layers, x, window.enabled);
-
-                if (bldcnt.upper & upper.flag)
-                    upper.color = bldfade.blendBlack(upper.color);
-                break;
-
-            case BlendMode::Disabled:
-                if (!alpha_object)
-                    upper = findUpperLayer<kObjects>(layers, x, window.enabled);
-                break;
-
-            default:
-                SHELL_UNREACHABLE;
-                break;
+                c.lower[x]          = visible ? c.upper[x]          : c.lower[x];
+                c.lower_flag[x]     = visible ? c.upper_flag[x]     : c.lower_flag[x];
+                c.lower_priority[x] = visible ? c.upper_priority[x] : c.lower_priority[x];
             }
+            c.upper[x]          = visible ? data[x]  : c.upper[x];
+            c.upper_flag[x]     = visible ? flag     : c.upper_flag[x];
+            c.upper_priority[x] = visible ? priority : c.upper_priority[x];
         }
-        else if (!alpha_object)
-        {
-            upper = findUpperLayer<kObjects>(layers, x, window.enabled);
-        }
-        color = Color::toArgb(upper.color);
     }
-}
 
-template<uint kWindows>
-const Window& Ppu::activeWindow(uint x) const
-{
-    if ((kWindows & Window::Flag::Win0) && winh[0].contains(x))
-        return winin.win0;
+    if (!kObjects)
+        return;
 
-    if ((kWindows & Window::Flag::Win1) && winh[1].contains(x))
-        return winin.win1;
+    constexpr u8 kObj = uint(Layer::Flag::Obj);
 
-    if ((kWindows & Window::Flag::WinObj) && objects[x].window)
-        return winout.winobj;
+    for (uint x = 0; x < kScreenW; ++x)
+    {
+        const auto& object = objects[x];
+
+        bool visible = object.isOpaque() && (c.enabled[x] & kObj);
+        bool upper   = visible && object.priority <= c.upper_priority[x];
 
-    return winout.winout;
+        if (kLower)
+        {
+            bool lower = visible && !upper && object.priority <= c.lower_priority[x];
+
+            c.lower[x]      = upper ? c.upper[x]      : lower ? object.color : c.lower[x];
+            c.lower_flag[x] = upper ? c.upper_flag[x] : lower ? kObj         : c.lower_flag[x];
+        }
+        c.upper[x]      = upper ? object.color : c.upper[x];
+        c.upper_flag[x] = upper ? kObj         : c.upper_flag[x];
+    }
 }
 
 template<bool kObjects>
-Ppu::ComposeLayer Ppu::findUpperLayer(const BackgroundLayers& layers, uint x, uint enabled)
+void Ppu::composeN(const BackgroundLayers& layers)
 {
-    auto& object = objects[x];
-    auto  object_visible = kObjects && (enabled & Layer::Flag::Obj) && object.isOpaque();
+    composeLayers<kObjects, false>(layers);
 
-    for (const auto& layer : layers)
-    {
-        if (object_visible && object <= layer)
-            return ComposeLayer(Layer::Flag::Obj, object.color);
+    auto& scanline = video_ctx.scanline(line);
 
-        if ((enabled & layer.flag) && layer.isOpaque(x))
-            return ComposeLayer(layer.flag, layer.color(x));
+    for (uint x = 0; x < kScreenW; ++x)
+    {
+        scanline[x] = pram.toArgb(composite.upper[x]);
     }
-
-    if (object_visible)
-        return ComposeLayer(Layer::Flag::Obj, object.color);
-
-    return ComposeLayer(Layer::Flag::Bdp, pram.backdrop());
 }
 
-template<bool kObjects>
-Ppu::ComposeLayers Ppu::findUpperLayers(const BackgroundLayers& layers, uint x, uint enabled)
+template<bool kObjects, uint kBlendMode>
+void Ppu::composeB(const BackgroundLayers& layers)
 {
-    auto& object = objects[x];
-    auto  object_used = false;
-    auto  object_visible = kObjects && (enabled & Layer::Flag::Obj) && object.isOpaque();
+    constexpr auto kMode  = BlendMode(kBlendMode);
+    constexpr auto kLower = kObjects || kMode == BlendMode::Alpha;
+
+    composeLayers<kObjects, kLower>(layers);
 
-    std::optional<ComposeLayer> upper;
+    const auto& c = composite;
+    auto& scanline = video_ctx.scanline(line);
 
-    for (const auto& layer : layers)
+    for (uint x = 0; x < kScreenW; ++x)
     {
-        if (object_visible && !object_used && object <= layer)
-        {
-            if (upper)
-                return ComposeLayers(*upper, ComposeLayer(Layer::Flag::Obj, object.color));
-            else
-                upper = ComposeLayer(Layer::Flag::Obj, object.color);
+        u16 color = c.upper[x];
 
-            object_used = true;
-        }
+        bool upper = c.blend[x] && (bldcnt.upper & c.upper_flag[x]);
+        bool alpha = false;
 
-        if ((enabled & layer.flag) && layer.isOpaque(x))
+        if (kLower)
         {
-            if (upper)
-                return ComposeLayers(*upper, ComposeLayer(layer.flag, layer.color(x)));
-            else
-                upper = ComposeLayer(layer.flag, layer.color(x));
+            bool lower = bldcnt.lower & c.lower_flag[x];
+
+            if (kObjects)
+                alpha = objects[x].alpha && c.upper_flag[x] == uint(Layer::Flag::Obj) && lower;
+
+            if (kMode == BlendMode::Alpha)
+                alpha = alpha || (upper && lower);
         }
-    }
 
-    if (object_visible && !object_used)
-    {
-        if (upper)
-            return ComposeLayers(*upper, ComposeLayer(Layer::Flag::Obj, object.color));
-        else
-            upper = ComposeLayer(Layer::Flag::Obj, object.color);
-    }
+        if (kMode == BlendMode::White)
+            color = upper && !alpha ? bldfade.blendWhite(pram.toRgb(color)) : color;
+
+        if (kMode == BlendMode::Black)
+            color = upper && !alpha ? bldfade.blendBlack(pram.toRgb(color)) : color;
 
-    if (!upper)
-        upper = ComposeLayer(Layer::Flag::Bdp, pram.backdrop());
+        if (kLower)
+            color = alpha ? bldalpha.blendAlpha(pram.toRgb(color), pram.toRgb(c.lower[x])) : color;
 
-    return ComposeLayers(*upper, ComposeLayer(Layer::Flag::Bdp, pram.backdrop()));
+        scanline[x] = pram.toArgb(color);
+    }
 }
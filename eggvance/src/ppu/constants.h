@@ -5,6 +5,8 @@
 inline constexpr uint kDecimalBits      = 8;
 inline constexpr uint kTransparent      = 0x8000;
 inline constexpr uint kColorMask        = 0x7FFF;
+inline constexpr uint kPaletteColor     = 0xC000;
+inline constexpr uint kPaletteEntry     = 0x01FF;
 inline constexpr uint kColorBytes       = 2;
 inline constexpr uint kTileSize         = 8;
 inline constexpr uint kTileBytes[2]     = { 32, 64 };
@@ -6,10 +6,6 @@
 #include "layers.h"
 #include "base/config.h"
 
-inline constexpr auto kMaskR = 0x1F <<  0;
-inline constexpr auto kMaskG = 0x1F <<  5;
-inline constexpr auto kMaskB = 0x1F << 10;
-
 DisplayControl::DisplayControl()
 {
     if (config.bios_skip)
@@ -204,6 +200,16 @@ bool WindowRange::contains(uint value) const
     return value >= min && value < max;
 }
 
+uint WindowRange::begin() const
+{
+    return std::min(min, max);
+}
+
+uint WindowRange::end() const
+{
+    return max;
+}
+
 void Mosaic::Block::write(u8 byte)
 {
     x = bit::seq<0, 4>(byte) + 1;
@@ -275,15 +281,6 @@ void BlendAlpha::write(uint index, u8 byte)
         evb = std::min<uint>(16, bit::seq<0, 5>(byte));
 }
 
-u16 BlendAlpha::blendAlpha(u16 a, u16 b) const
-{
-    uint rr = std::min<uint>(kMaskR, ((a & kMaskR) * eva + (b & kMaskR) * evb) >> 4);
-    uint gg = std::min<uint>(kMaskG, ((a & kMaskG) * eva + (b & kMaskG) * evb) >> 4);
-    uint bb = std::min<uint>(kMaskB, ((a & kMaskB) * eva + (b & kMaskB) * evb) >> 4);
-
-    return (rr & kMaskR) | (gg & kMaskG) | (bb & kMaskB);
-}
-
 void BlendFade::write(uint index, u8 byte)
 {
     if (index == 1)
@@ -293,29 +290,3 @@ void BlendFade::write(uint index, u8 byte)
 
     evy = std::min<uint>(16, bit::seq<0, 5>(byte));
 }
-
-u16 BlendFade::blendWhite(u16 a) const
-{
-    uint r = a & kMaskR;
-    uint g = a & kMaskG;
-    uint b = a & kMaskB;
-
-    r += ((kMaskR - r) * evy) >> 4;
-    g += ((kMaskG - g) * evy) >> 4;
-    b += ((kMaskB - b) * evy) >> 4;
-
-    return (r & kMaskR) | (g & kMaskG) | (b & kMaskB);
-}
-
-u16 BlendFade::blendBlack(u16 a) const
-{
-    uint r = a & kMaskR;
-    uint g = a & kMaskG;
-    uint b = a & kMaskB;
-
-    r -= (r * evy) >> 4;
-    g -= (g * evy) >> 4;
-    b -= (b * evy) >> 4;
-
-    return (r & kMaskR) | (g & kMaskG) | (b & kMaskB);
-}
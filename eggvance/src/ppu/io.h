@@ -1,5 +1,8 @@
 #pragma once
 
+#include <shell/macros.h>
+
+#include "color.h"
 #include "point.h"
 #include "base/register.h"
 
@@ -116,6 +119,8 @@ class WindowRange : public RegisterW<u16>
     void write(uint index, u8 byte);
 
     bool contains(uint value) const;
+    uint begin() const;
+    uint end() const;
 
 private:
     uint min   = 0;
@@ -165,7 +170,13 @@ class BlendAlpha : public Register<u16, 0x1F1F>
 public:
     void write(uint index, u8 byte);
 
-    u16 blendAlpha(u16 a, u16 b) const;
+    SHELL_INLINE u16 blendAlpha(u16 a, u16 b) const
+    {
+        u32 color = ((Color::spread(a) * eva + Color::spread(b) * evb) >> 4) & 0x07E0'FC3F;
+        u32 carry = color & 0x0400'8020;
+
+        return Color::pack(color | (carry - (carry >> 5)));
+    }
 
 private:
     uint eva = 0;
@@ -177,8 +188,20 @@ class BlendFade : public RegisterW<u16, 0x001F>
 public:
     void write(uint index, u8 byte);
 
-    u16 blendWhite(u16 a) const;
-    u16 blendBlack(u16 a) const;
+    SHELL_INLINE u16 blendWhite(u16 a) const
+    {
+        u32 color = Color::spread(a);
+
+        return Color::pack(color + ((((Color::kSpreadMask - color) * evy) >> 4) & Color::kSpreadMask));
+    }
+
+    // Green and blue round the subtracted amount up, red rounds it down
+    SHELL_INLINE u16 blendBlack(u16 a) const
+    {
+        u32 color = Color::spread(a);
+
+        return Color::pack(color - ((((color * evy) + 0x01E0'3C00) >> 4) & Color::kSpreadMask));
+    }
 
 private:
     uint evy = 0;
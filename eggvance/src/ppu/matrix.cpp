@@ -33,6 +33,18 @@ Point TransformationMatrix::operator*(s32 x) const
     return result >> kDecimalBits;
 }
 
+Point TransformationMatrix::reference() const
+{
+    return Point(
+        get(0, 1) * yx + get(0, 2),
+        get(1, 1) * yy + get(1, 2));
+}
+
+Point TransformationMatrix::delta() const
+{
+    return Point(get(0, 0), get(1, 0));
+}
+
 void TransformationMatrix::writeA(uint index, u8 byte)
 {
     setByte<16>(0, 0, index, byte);
@@ -74,6 +74,9 @@ class TransformationMatrix : public Matrix<s32, 2, 3>
 
     Point operator*(s32 x) const;
 
+    Point reference() const;
+    Point delta() const;
+
     void writeA(uint index, u8 byte);
     void writeB(uint index, u8 byte);
     void writeC(uint index, u8 byte);
@@ -4,6 +4,14 @@
 
 #include "base/bit.h"
 
+Oam::Oam()
+{
+    for (uint index = 0; index < entries.size(); ++index)
+    {
+        bin(index, 0, 0);
+    }
+}
+
 void Oam::writeHalf(u32 addr, u16 half)
 {
     addr &= ~0x1;
@@ -12,6 +20,9 @@ void Oam::writeHalf(u32 addr, u16 half)
     auto& entry = entries[addr >> 3];
     auto& matrix = matrices[addr >> 5];
 
+    uint begin = entry.line_begin;
+    uint end   = entry.line_end;
+
     switch (addr & 0x6)
     {
     case 0: entry.writeAttr0(half); break;
@@ -25,6 +36,9 @@ void Oam::writeHalf(u32 addr, u16 half)
     }
 
     writeFast<u16>(addr, half);
+
+    if (begin != entry.line_begin || end != entry.line_end)
+        bin(addr >> 3, begin, end);
 }
 
 void Oam::writeWord(u32 addr, u32 word)
@@ -34,3 +48,16 @@ void Oam::writeWord(u32 addr, u32 word)
     writeHalf(addr + 0, bit::seq< 0, 16>(word));
     writeHalf(addr + 2, bit::seq<16, 16>(word));
 }
+
+void Oam::bin(uint index, uint begin, uint end)
+{
+    const auto& entry = entries[index];
+
+    u64 mask = 1ULL << (index % 64);
+
+    for (uint line = begin; line < end; ++line)
+        lines[line][index / 64] &= ~mask;
+
+    for (uint line = entry.line_begin; line < entry.line_end; ++line)
+        lines[line][index / 64] |= mask;
+}
@@ -1,5 +1,6 @@
 #include "oamentry.h"
 
+#include <algorithm>
 #include <shell/operators.h>
 
 #include "constants.h"
@@ -45,13 +46,6 @@ void OamEntry::writeAttr2(u16 half)
     compute();
 }
 
-bool OamEntry::isVisible(uint line) const
-{
-    return visible_x
-        && static_cast<int>(line) >= origin.y
-        && static_cast<int>(line) < (origin.y + screen_size.y);
-}
-
 uint OamEntry::tileBytes() const
 {
     return kTileBytes[color_mode];
@@ -101,4 +95,15 @@ void OamEntry::compute()
     if (flip.y) flip.y = sprite_size.y - 1;
 
     visible_x = (origin.x + screen_size.x) >= 0 && origin.x < kScreenW;
+
+    if (visible_x && !disabled)
+    {
+        line_begin = std::clamp<int>(origin.y, 0, kScreenH);
+        line_end   = std::clamp<int>(origin.y + screen_size.y, 0, kScreenH);
+    }
+    else
+    {
+        line_begin = 0;
+        line_end   = 0;
+    }
 }
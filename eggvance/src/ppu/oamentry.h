@@ -12,7 +12,6 @@ class OamEntry
     void writeAttr1(u16 half);
     void writeAttr2(u16 half);
 
-    bool isVisible(uint line) const;
     uint tileBytes() const;
     uint tilesPerRow(uint layout) const;
     uint paletteBank() const;
@@ -26,6 +25,8 @@ class OamEntry
     uint matrix      = 0;
     uint priority    = 0;
     uint base_addr   = 0;
+    uint line_begin  = 0;
+    uint line_end    = 0;
 
     Point flip;
     Point origin;
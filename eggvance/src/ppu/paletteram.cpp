@@ -1,6 +1,7 @@
 #include "paletteram.h"
 
 #include "constants.h"
+#include "base/bit.h"
 
 inline constexpr auto kBankBytes = 0x20;
 inline constexpr auto kPaletteFg = 0x200;
@@ -10,6 +11,29 @@ void PaletteRam::writeByte(u32 addr, u8 byte)
     writeHalf(addr, byte * 0x0101);
 }
 
+void PaletteRam::writeHalf(u32 addr, u16 half)
+{
+    Ram::writeHalf(addr, half);
+
+    argb[mirror(addr) / kColorBytes] = Color::toArgb(half & kColorMask);
+}
+
+void PaletteRam::writeWord(u32 addr, u32 word)
+{
+    addr &= ~0x3;
+
+    writeHalf(addr + 0, bit::seq< 0, 16>(word));
+    writeHalf(addr + 2, bit::seq<16, 16>(word));
+}
+
+void PaletteRam::convert()
+{
+    for (uint entry = 0; entry < argb.size(); ++entry)
+    {
+        argb[entry] = Color::toArgb(readFast<u16>(kColorBytes * entry) & kColorMask);
+    }
+}
+
 u16 PaletteRam::colorFg(uint index, uint bank) const
 {
     return index == 0
@@ -26,15 +50,15 @@ u16 PaletteRam::colorBg(uint index, uint bank) const
 
 u16 PaletteRam::colorFgOpaque(uint index, uint bank) const
 {
-    return readFast<u16>(kPaletteFg + kBankBytes * bank + kColorBytes * index) & kColorMask;
+    return kPaletteColor | ((kPaletteFg + kBankBytes * bank + kColorBytes * index) / kColorBytes);
 }
 
 u16 PaletteRam::colorBgOpaque(uint index, uint bank) const
 {
-    return readFast<u16>(kBankBytes * bank + kColorBytes * index) & kColorMask;
+    return kPaletteColor | ((kBankBytes * bank + kColorBytes * index) / kColorBytes);
 }
 
 u16 PaletteRam::backdrop() const
 {
-    return readFast<u16>(0) & kColorMask;
+    return kPaletteColor;
 }
@@ -1,15 +1,44 @@
 #pragma once
 
+#include <shell/array.h>
+#include <shell/macros.h>
+
+#include "color.h"
+#include "constants.h"
 #include "base/ram.h"
 
+// Color lookups return references to palette entries (kPaletteColor | entry)
+// which are resolved when composing. The entries are kept converted to the
+// host format.
 class PaletteRam : public Ram<1024>
 {
 public:
     void writeByte(u32 addr, u8 byte);
+    void writeHalf(u32 addr, u16 half);
+    void writeWord(u32 addr, u32 word);
+
+    void convert();
 
     u16 colorFg(uint index, uint bank = 0) const;
     u16 colorBg(uint index, uint bank = 0) const;
     u16 colorFgOpaque(uint index, uint bank = 0) const;
     u16 colorBgOpaque(uint index, uint bank = 0) const;
     u16 backdrop() const;
+
+    SHELL_INLINE u16 toRgb(u16 color) const
+    {
+        return color > kColorMask
+            ? readFast<u16>(kColorBytes * (color & kPaletteEntry)) & kColorMask
+            : color;
+    }
+
+    SHELL_INLINE u32 toArgb(u16 color) const
+    {
+        return color > kColorMask
+            ? argb[color & kPaletteEntry]
+            : Color::toArgb(color);
+    }
+
+private:
+    shell::array<u32, 512> argb = {};
 };
@@ -8,6 +8,8 @@
 
 void Ppu::init()
 {
+    pram.convert();
+
     events.hblank = [this](u64 late)
     {
         hblank(late);
@@ -32,11 +34,15 @@ void Ppu::hblank(u64 late)
 
     if (vcount < 160)
     {
-        render();
-
-        backgrounds[2].matrix.hblank();
-        backgrounds[3].matrix.hblank();
-
+        if (config.render_thread)
+        {
+            thread.submit(vcount);
+        }
+        else
+        {
+            thread.sync();
+            scanline(vcount);
+        }
         dma.broadcast(Dma::Event::HBlank);
     }
 
@@ -63,6 +69,7 @@ void Ppu::hblankEnd(u64 late)
 
     if (vcount == 160)
     {
+        thread.sync();
         video_ctx.renderFrame();
 
         backgrounds[2].matrix.vblank();
@@ -77,3 +84,13 @@ void Ppu::hblankEnd(u64 late)
 
     scheduler.insert(events.hblank, 1006 - late);
 }
+
+void Ppu::scanline(uint line)
+{
+    this->line = line;
+
+    render();
+
+    backgrounds[2].matrix.hblank();
+    backgrounds[3].matrix.hblank();
+}
@@ -6,6 +6,7 @@
 #include "layers.h"
 #include "oam.h"
 #include "paletteram.h"
+#include "renderthread.h"
 #include "videoram.h"
 #include "scheduler/event.h"
 
@@ -14,6 +15,11 @@ class Ppu
 public:
     void init();
 
+    SHELL_INLINE void sync()
+    {
+        thread.sync();
+    }
+
     DisplayControl dispcnt;
     Register<u16, 0x0001> greenswap;
     DisplayStatus dispstat;
@@ -35,27 +41,19 @@ class Ppu
     Oam oam = {};
 
 private:
-    struct ComposeLayer
-    {
-        ComposeLayer() = default;
-        template<typename Flag>
-        ComposeLayer(Flag flag, uint color)
-            : flag(static_cast<uint>(flag)), color(color) {}
+    friend class RenderThread;
 
-        uint flag  = 0;
-        uint color = 0;
-    };
-
-    using ComposeLayers    = std::tuple<ComposeLayer, ComposeLayer>;
     using BackgroundRender = void(Ppu::*)(Background&);
     using BackgroundLayers = shell::FixedVector<BackgroundLayer, 4>;
 
     void hblank(u64 late);
     void hblankEnd(u64 late);
 
+    void scanline(uint line);
     void render();
     void renderBackground(BackgroundRender render, Background& background);
     void renderObjects();
+    void renderObject(const OamEntry& entry);
 
     template<uint kColorMode>
     void renderBackground0(Background& background);
@@ -66,32 +64,38 @@ class Ppu
     void renderBackground5(Background& background);
 
     void compose(uint possible);
+    uint composeWindows(uint windows);
+    template<bool kObjects, bool kLower>
+    void composeLayers(const BackgroundLayers& layers);
     template<bool kObjects>
-    void composeNN(const BackgroundLayers& layers);
-    template<bool kObjects, uint kWindows>
-    void composeNW(const BackgroundLayers& layers);
+    void composeN(const BackgroundLayers& layers);
     template<bool kObjects, uint kBlendMode>
-    void composeBN(const BackgroundLayers& layers);
-    template<bool kObjects, uint kBlendMode, uint kWindows>
-    void composeBW(const BackgroundLayers& layers);
-
-    template<uint kWindows>
-    const Window& activeWindow(uint x) const;
-
-    template<bool kObjects>
-    ComposeLayer  findUpperLayer( const BackgroundLayers& layers, uint x, uint enabled = 0xFFFF'FFFF);
-    template<bool kObjects>
-    ComposeLayers findUpperLayers(const BackgroundLayers& layers, uint x, uint enabled = 0xFFFF'FFFF);
+    void composeB(const BackgroundLayers& layers);
 
+    uint line = 0;
     uint objects_exist = false;
     uint objects_alpha = false;
     ScanlineBuffer<ObjectLayer> objects;
 
+    struct Composite
+    {
+        ScanlineBuffer<u16> upper;
+        ScanlineBuffer<u16> lower;
+        ScanlineBuffer<u8>  upper_flag;
+        ScanlineBuffer<u8>  lower_flag;
+        ScanlineBuffer<u8>  upper_priority;
+        ScanlineBuffer<u8>  lower_priority;
+        ScanlineBuffer<u8>  enabled;
+        ScanlineBuffer<u8>  blend;
+    } composite;
+
     struct Events
     {
-        Event hblank;
-        Event hblank_end;
+        Event hblank{"ppu.hblank"};
+        Event hblank_end{"ppu.hblank_end"};
     } events;
+
+    RenderThread thread;
 };
 
 inline Ppu ppu;
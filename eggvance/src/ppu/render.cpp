@@ -3,9 +3,9 @@
 #include <shell/macros.h>
 #include <shell/operators.h>
 
-#include "color.h"
 #include "mapentry.h"
 #include "matrix.h"
+#include "base/bit.h"
 #include "base/config.h"
 #include "frontend/videocontext.h"
 
@@ -13,15 +13,15 @@ void Ppu::render()
 {
     if (dispcnt.blank)
     {
-        auto& scanline = video_ctx.scanline(vcount);
+        auto& scanline = video_ctx.scanline(line);
         scanline.fill(0xFFFF'FFFF);
         return;
     }
 
     if (!dispcnt.isActive())
     {
-        auto& scanline = video_ctx.scanline(vcount);
-        scanline.fill(Color::toArgb(pram.backdrop()));
+        auto& scanline = video_ctx.scanline(line);
+        scanline.fill(pram.toArgb(pram.backdrop()));
         return;
     }
 
@@ -85,7 +85,7 @@ void Ppu::renderBackground(BackgroundRender render, Background& background)
     if ((dispcnt.enabled & (1 << background.id)) == 0)
         return;
 
-    if (background.control.mosaic && mosaic.bgs.isMosaicY() && !mosaic.bgs.isDominantY(vcount))
+    if (background.control.mosaic && mosaic.bgs.isMosaicY() && !mosaic.bgs.isDominantY(line))
     {
         background.buffer.flip();
     }
@@ -108,7 +108,7 @@ void Ppu::renderBackground0(Background& background)
 {
     const auto size = background.control.sizeRegular();
 
-    Point origin = (background.offset + Point(0, vcount)) % size;
+    Point origin = (background.offset + Point(0, line)) % size;
 
     auto pixel = origin % kTileSize;
     auto tile  = origin / kTileSize % kMapBlockTiles;
@@ -127,11 +127,15 @@ void Ppu::renderBackground0(Background& background)
             u32 addr = background.control.tile_block + kTileBytes[kColorMode] * entry.tile;
             if (addr < kObjectBase)
             {
+                addr += kTileBytes[kColorMode] / kTileSize * (pixel.y ^ entry.flip.y);
+
+                u64 row = kColorMode == ColorMode::C16x16
+                    ? vram.row16x16(addr)
+                    : vram.row256x1(addr);
+
                 for (; pixel.x < kTileSize; ++pixel.x)
                 {
-                    uint index = kColorMode == ColorMode::C16x16
-                        ? vram.index16x16(addr, pixel ^ entry.flip)
-                        : vram.index256x1(addr, pixel ^ entry.flip);
+                    uint index = static_cast<u8>(row >> (8 * (pixel.x ^ entry.flip.x)));
 
                     background.buffer[x] = kColorMode == ColorMode::C16x16
                         ? pram.colorBg(index, entry.bank)
@@ -171,36 +175,37 @@ void Ppu::renderBackground0(Background& background)
 
 void Ppu::renderBackground2(Background& background)
 {
-    const auto size = background.control.sizeAffine();
+    const auto size  = background.control.sizeAffine();
+    const auto tiles = size.x / kTileSize;
+    const auto wrap  = background.control.wraparound;
 
-    for (auto [x, color] : shell::enumerate(background.buffer))
+    shell::array<u32, kScreenW> maps;
+    shell::array<u32, kScreenW> pixels;
+    shell::array<u8,  kScreenW> visible;
+
+    auto reference = background.matrix.reference();
+    auto delta     = background.matrix.delta();
+
+    for (uint x = 0; x < kScreenW; ++x, reference += delta)
     {
-        auto texel = background.matrix * x;
+        auto texel = reference >> kDecimalBits;
 
-        if (static_cast<uint>(texel.x) >= size.x ||
-            static_cast<uint>(texel.y) >= size.y)
-        {
-            if (background.control.wraparound)
-            {
-                texel %= size;
+        visible[x] = wrap
+            || (static_cast<uint>(texel.x) < static_cast<uint>(size.x)
+            &&  static_cast<uint>(texel.y) < static_cast<uint>(size.y));
 
-                if (texel.x < 0) texel.x += size.x;
-                if (texel.y < 0) texel.y += size.y;
-            }
-            else
-            {
-                color = kTransparent;
-                continue;
-            }
-        }
+        texel &= size.x - 1;
 
-        const auto pixel = texel % kTileSize;
-        const auto tile  = texel / kTileSize;
+        maps[x]   = background.control.map_block + (texel / kTileSize).index2d(tiles);
+        pixels[x] = (texel % kTileSize).index2d(kTileSize);
+    }
 
-        uint entry = vram.readFast<u8>(background.control.map_block + tile.index2d(size.x / kTileSize));
-        uint index = vram.index256x1(background.control.tile_block + kTileBytes[uint(ColorMode::C256x1)] * entry, pixel);
+    for (uint x = 0; x < kScreenW; ++x)
+    {
+        uint entry = vram.readFast<u8>(maps[x]);
+        uint index = vram.readFast<u8>(background.control.tile_block + kTileBytes[uint(ColorMode::C256x1)] * entry + pixels[x]);
 
-        color = pram.colorBg(index);
+        background.buffer[x] = visible[x] ? pram.colorBg(index) : kTransparent;
     }
 }
 
@@ -270,91 +275,108 @@ void Ppu::renderObjects()
 {
     s64 cycles = dispcnt.oam_free ? 954 : 1210;
 
-    for (const auto& entry : oam.entries)
+    for (uint bin = 0; bin < 2; ++bin)
     {
-        if (entry.disabled || !entry.isVisible(vcount))
-            continue;
+        for (uint index : bit::iterate(oam.lines[line][bin]))
+        {
+            const auto& entry = oam.entries[64 * bin + index];
 
-        const auto& origin      = entry.origin;
-        const auto& center      = entry.center;
-        const auto& sprite_size = entry.sprite_size;
-        const auto& screen_size = entry.screen_size;
-        const auto& matrix      = entry.affine ? oam.matrices[entry.matrix] : kIdentityMatrix;
+            renderObject(entry);
 
-        uint tile_bytes = entry.tileBytes();
-        uint tiles_row  = entry.tilesPerRow(dispcnt.layout);
-        uint bank       = entry.paletteBank();
+            cycles -= entry.cycles();
+            if (cycles <= 0)
+                return;
+        }
+    }
+}
 
-        Point offset(
-            -center.x + origin.x - std::min(origin.x, 0),
-            -center.y + vcount);
+void Ppu::renderObject(const OamEntry& entry)
+{
+    const auto& origin      = entry.origin;
+    const auto& center      = entry.center;
+    const auto& sprite_size = entry.sprite_size;
+    const auto& screen_size = entry.screen_size;
+    const auto& matrix      = entry.affine ? oam.matrices[entry.matrix] : kIdentityMatrix;
 
-        uint end = std::min<uint>(origin.x + screen_size.x, kScreenW);
+    uint tile_bytes = entry.tileBytes();
+    uint tiles_row  = entry.tilesPerRow(dispcnt.layout);
+    uint bank       = entry.paletteBank();
 
-        for (uint x = center.x + offset.x; x < end; ++x, ++offset.x)
-        {
-            auto texel = (matrix * offset) + (sprite_size / 2);
+    Point offset(
+        -center.x + origin.x - std::min(origin.x, 0),
+        -center.y + line);
 
-            if (static_cast<uint>(texel.x) >= sprite_size.x ||
-                static_cast<uint>(texel.y) >= sprite_size.y)
-                continue;
+    uint end = std::min<uint>(origin.x + screen_size.x, kScreenW);
 
-            if (!entry.affine)
-                texel ^= entry.flip;
+    u64 row = 0;
+    u32 row_addr = 0xFFFF'FFFF;
 
-            if (entry.mosaic)
-            {
-                texel.x = mosaic.obj.mosaicX(texel.x);
-                texel.y = mosaic.obj.mosaicY(texel.y);
-            }
+    for (uint x = center.x + offset.x; x < end; ++x, ++offset.x)
+    {
+        auto texel = (matrix * offset) + (sprite_size / 2);
 
-            const auto tile  = texel / kTileSize;
-            const auto pixel = texel % kTileSize;
+        if (static_cast<uint>(texel.x) >= sprite_size.x ||
+            static_cast<uint>(texel.y) >= sprite_size.y)
+            continue;
 
-            u32 addr = vram.mirror(entry.base_addr + tile_bytes * tile.index2d(tiles_row));
-            if (addr < kObjectBaseBitmap && dispcnt.isBitmap())
-                continue;
+        if (!entry.affine)
+            texel ^= entry.flip;
 
-            auto& object = objects[x];
+        if (entry.mosaic)
+        {
+            texel.x = mosaic.obj.mosaicX(texel.x);
+            texel.y = mosaic.obj.mosaicY(texel.y);
+        }
 
-            uint index = vram.index(addr, pixel, entry.color_mode);
+        const auto tile  = texel / kTileSize;
+        const auto pixel = texel % kTileSize;
 
-            switch (ObjectMode(entry.object_mode))
-            {
-            case ObjectMode::Normal:
-            case ObjectMode::Alpha:
-                if (entry.priority < object.priority || !object.isOpaque())
-                {
-                    if (index != 0)
-                    {
-                        object.color  = pram.colorFgOpaque(index, bank);
-                        object.alpha  = entry.object_mode == ObjectMode::Alpha;
-                        objects_exist = true;
-                        objects_alpha |= object.alpha;
-                    }
-                    object.priority = entry.priority;
-                }
-                break;
+        u32 addr = vram.mirror(entry.base_addr + tile_bytes * tile.index2d(tiles_row));
+        if (addr < kObjectBaseBitmap && dispcnt.isBitmap())
+            continue;
+
+        addr += tile_bytes / kTileSize * pixel.y;
+        if (addr != row_addr)
+        {
+            row = vram.row(addr, entry.color_mode);
+            row_addr = addr;
+        }
+
+        auto& object = objects[x];
 
-            case ObjectMode::Window:
+        uint index = static_cast<u8>(row >> (8 * pixel.x));
+
+        switch (ObjectMode(entry.object_mode))
+        {
+        case ObjectMode::Normal:
+        case ObjectMode::Alpha:
+            if (entry.priority < object.priority || !object.isOpaque())
+            {
                 if (index != 0)
                 {
-                    object.window = true;
+                    object.color  = pram.colorFgOpaque(index, bank);
+                    object.alpha  = entry.object_mode == ObjectMode::Alpha;
                     objects_exist = true;
+                    objects_alpha |= object.alpha;
                 }
-                break;
-
-            case ObjectMode::Invalid:
-                break;
+                object.priority = entry.priority;
+            }
+            break;
 
-            default:
-                SHELL_UNREACHABLE;
-                break;
+        case ObjectMode::Window:
+            if (index != 0)
+            {
+                object.window = true;
+                objects_exist = true;
             }
-        }
+            break;
 
-        cycles -= entry.cycles();
-        if (cycles <= 0)
+        case ObjectMode::Invalid:
             break;
+
+        default:
+            SHELL_UNREACHABLE;
+            break;
+        }
     }
 }
@@ -0,0 +1,62 @@
+#include "renderthread.h"
+
+#include "ppu.h"
+
+RenderThread::~RenderThread()
+{
+    if (!thread.joinable())
+        return;
+
+    sync();
+    {
+        std::lock_guard lock(mutex);
+        stop = true;
+    }
+    condition.notify_one();
+    thread.join();
+}
+
+void RenderThread::submit(uint line)
+{
+    if (!thread.joinable())
+        thread = std::thread(&RenderThread::run, this);
+
+    uint index = submitted.load(std::memory_order_relaxed);
+    lines[index % kScreenH] = line;
+    {
+        std::lock_guard lock(mutex);
+        submitted.store(index + 1, std::memory_order_release);
+    }
+    condition.notify_one();
+}
+
+void RenderThread::run()
+{
+    while (true)
+    {
+        uint index = completed.load(std::memory_order_relaxed);
+        {
+            std::unique_lock lock(mutex);
+            condition.wait(lock, [&]()
+            {
+                return stop || index != submitted.load(std::memory_order_acquire);
+            });
+
+            if (stop)
+                return;
+        }
+
+        do
+        {
+            ppu.scanline(lines[index % kScreenH]);
+            completed.store(++index, std::memory_order_release);
+        }
+        while (index != submitted.load(std::memory_order_acquire));
+    }
+}
+
+void RenderThread::wait()
+{
+    while (completed.load(std::memory_order_acquire) != submitted.load(std::memory_order_relaxed))
+        std::this_thread::yield();
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <shell/array.h>
+#include <shell/macros.h>
+
+#include "base/constants.h"
+#include "base/int.h"
+
+class RenderThread
+{
+public:
+    ~RenderThread();
+
+    void submit(uint line);
+
+    SHELL_INLINE void sync()
+    {
+        if (completed.load(std::memory_order_acquire) != submitted.load(std::memory_order_relaxed))
+            wait();
+    }
+
+private:
+    void run();
+    void wait();
+
+    std::thread thread;
+    std::mutex mutex;
+    std::condition_variable condition;
+    std::atomic<uint> submitted = 0;
+    std::atomic<uint> completed = 0;
+    shell::array<uint, kScreenH> lines = {};
+    bool stop = false;
+};
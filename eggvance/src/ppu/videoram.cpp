@@ -4,7 +4,6 @@
 
 #include "constants.h"
 #include "ppu.h"
-#include "base/bit.h"
 
 u32 VideoRamMirror::operator()(u32 addr) const
 {
@@ -18,24 +17,54 @@ void VideoRam::writeByte(u32 addr, u8 byte)
     if (addr < (ppu.dispcnt.isBitmap() ? kObjectBaseBitmap : kObjectBase))
     {
         writeFast<u16>(addr & ~0x1, byte * 0x0101);
+        dirty[addr / 32] = true;
     }
 }
 
-uint VideoRam::index16x16(u32 addr, const Point& pixel) const
+void VideoRam::writeHalf(u32 addr, u16 half)
 {
-    u8 data = readFast<u8>(addr + pixel.index2d(kTileSize) / 2);
+    Ram::writeHalf(addr, half);
+    dirty[mirror(addr) / 32] = true;
+}
 
-    return bit::nibble(data, pixel.x & 0x1);
+void VideoRam::writeWord(u32 addr, u32 word)
+{
+    Ram::writeWord(addr, word);
+    dirty[mirror(addr) / 32] = true;
 }
 
-uint VideoRam::index256x1(u32 addr, const Point& pixel) const
+u64 VideoRam::row16x16(u32 addr)
 {
-    return readFast<u8>(addr + pixel.index2d(kTileSize));
+    if (dirty[addr / 32])
+        decode(addr / 32);
+
+    return rows[addr / 4];
 }
 
-uint VideoRam::index(u32 addr, const Point& pixel, uint color_mode) const
+u64 VideoRam::row256x1(u32 addr) const
+{
+    return readFast<u64>(addr);
+}
+
+u64 VideoRam::row(u32 addr, uint color_mode)
 {
     return color_mode == ColorMode::C16x16
-        ? index16x16(addr, pixel)
-        : index256x1(addr, pixel);
+        ? row16x16(addr)
+        : row256x1(addr);
+}
+
+void VideoRam::decode(uint tile)
+{
+    dirty[tile] = false;
+
+    for (uint row = 8 * tile; row < 8 * tile + 8; ++row)
+    {
+        u64 data = readFast<u32>(4 * row);
+
+        data = (data | (data << 16)) & 0x0000'FFFF'0000'FFFF;
+        data = (data | (data <<  8)) & 0x00FF'00FF'00FF'00FF;
+        data = (data | (data <<  4)) & 0x0F0F'0F0F'0F0F'0F0F;
+
+        rows[row] = data;
+    }
 }
@@ -1,6 +1,5 @@
 #pragma once
  
-#include "point.h"
 #include "base/ram.h"
 
 class VideoRamMirror
@@ -13,8 +12,19 @@ class VideoRam : public Ram<96 * 1024, VideoRamMirror>
 {
 public:
     void writeByte(u32 addr, u8 byte);
+    void writeHalf(u32 addr, u16 half);
+    void writeWord(u32 addr, u32 word);
 
-    uint index16x16(u32 addr, const Point& pixel) const;
-    uint index256x1(u32 addr, const Point& pixel) const;
-    uint index(u32 addr, const Point& pixel, uint color_mode) const;
+    u64 row16x16(u32 addr);
+    u64 row256x1(u32 addr) const;
+    u64 row(u32 addr, uint color_mode);
+
+private:
+    static constexpr uint kRows  = 96 * 1024 / 4;
+    static constexpr uint kTiles = 96 * 1024 / 32;
+
+    void decode(uint tile);
+
+    shell::array<u64, kRows> rows = {};
+    shell::array<u8, kTiles> dirty = {};
 };
@@ -2,12 +2,13 @@
 
 bool Event::operator<(const Event& other) const
 {
-    return when < other.when;
+    // Events inserted later run first on ties
+    return when < other.when || (when == other.when && order > other.order);
 }
 
 bool Event::operator>(const Event& other) const
 {
-    return when > other.when;
+    return other < *this;
 }
 
 bool Event::isScheduled() const
@@ -1,24 +1,51 @@
 #pragma once
 
-#include <functional>
+#include <new>
+#include <type_traits>
+#include <shell/macros.h>
 
-#include "node.h"
 #include "base/int.h"
 
-class Event : public Node<Event>
+class Event
 {
 public:
+    explicit Event(const char* name = "event")
+        : name(name) {}
+
+    // Stores small, trivially copyable callables inline, e.g. [this] lambdas
     template<typename Function>
     Event& operator=(Function&& func)
     {
-        callback = std::forward<Function>(func);
+        using Callable = std::decay_t<Function>;
+
+        static_assert(sizeof(Callable) <= sizeof(storage));
+        static_assert(alignof(Callable) <= alignof(void*));
+        static_assert(std::is_trivially_copyable_v<Callable>);
+        static_assert(std::is_trivially_destructible_v<Callable>);
+
+        new (storage) Callable(std::forward<Function>(func));
+        callback = [](void* data, u64 late)
+        {
+            (*std::launder(static_cast<Callable*>(data)))(late);
+        };
         return *this;
     }
 
+    SHELL_INLINE void operator()(u64 late)
+    {
+        callback(storage, late);
+    }
+
     bool operator<(const Event& other) const;
     bool operator>(const Event& other) const;
     bool isScheduled() const;
 
     u64 when = 0;
-    std::function<void(u64)> callback;
+    u64 order = 0;
+    uint index = 0;
+    const char* name;
+
+private:
+    void(*callback)(void*, u64) = nullptr;
+    alignas(void*) u8 storage[2 * sizeof(void*)] = {};
 };
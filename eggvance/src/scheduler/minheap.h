@@ -0,0 +1,99 @@
+#pragma once
+
+#include <shell/array.h>
+#include <shell/macros.h>
+
+#include "base/int.h"
+
+template<typename T, uint kCapacity>
+class MinHeap
+{
+public:
+    bool empty() const
+    {
+        return size == 0;
+    }
+
+    T& top() const
+    {
+        SHELL_ASSERT(size);
+
+        return *heap[0];
+    }
+
+    void insert(T& item)
+    {
+        SHELL_ASSERT(size < kCapacity);
+
+        item.index = size;
+        heap[size++] = &item;
+        up(item.index);
+    }
+
+    void remove(T& item)
+    {
+        SHELL_ASSERT(item.index < size && heap[item.index] == &item);
+
+        uint index = item.index;
+        if (index == --size)
+            return;
+
+        place(index, heap[size]);
+
+        if (index > 0 && *heap[index] < *heap[parent(index)])
+            up(index);
+        else
+            down(index);
+    }
+
+    T& pop()
+    {
+        T& item = top();
+        remove(item);
+        return item;
+    }
+
+private:
+    static constexpr uint parent(uint index) { return (index - 1) / 2; }
+    static constexpr uint child(uint index)  { return 2 * index + 1; }
+
+    void place(uint index, T* item)
+    {
+        heap[index] = item;
+        item->index = index;
+    }
+
+    void up(uint index)
+    {
+        T* item = heap[index];
+
+        while (index > 0 && *item < *heap[parent(index)])
+        {
+            place(index, heap[parent(index)]);
+            index = parent(index);
+        }
+        place(index, item);
+    }
+
+    void down(uint index)
+    {
+        T* item = heap[index];
+
+        while (child(index) < size)
+        {
+            uint min = child(index);
+            if (min + 1 < size && *heap[min + 1] < *heap[min])
+                min++;
+
+            if (!(*heap[min] < *item))
+                break;
+
+            place(index, heap[min]);
+            index = min;
+        }
+        place(index, item);
+    }
+
+    uint size = 0;
+    shell::array<T*, kCapacity> heap = {};
+};
@@ -1,9 +0,0 @@
-#pragma once
-
-template<typename T>
-class Node
-{
-public:
-    T* prev = nullptr;
-    T* next = nullptr;
-};
@@ -0,0 +1,42 @@
+#ifdef EGGVANCE_PROFILE
+
+#include "profiler.h"
+
+#include <shell/fmt.h>
+
+Profiler::~Profiler()
+{
+    fmt::print("{:<16} {:>12} {:>12} {:>10}  late histogram (0, 1, 2-3, 4-7, ...)\n", "event", "count", "total ms", "avg ns");
+
+    for (const auto& [name, entry] : stats)
+    {
+        fmt::print("{:<16} {:>12} {:>12.3f} {:>10.1f} ",
+            name,
+            entry.count,
+            entry.nanoseconds / 1e6,
+            double(entry.nanoseconds) / double(entry.count));
+
+        for (const auto& count : entry.late)
+            fmt::print(" {}", count);
+
+        fmt::print("\n");
+    }
+}
+
+void Profiler::run(Event& event, u64 late)
+{
+    auto begin = Clock::now();
+    event(late);
+    auto end = Clock::now();
+
+    uint bucket = 0;
+    while (bucket < kBuckets - 1 && (late >> bucket))
+        bucket++;
+
+    Stats& entry = stats[event.name];
+    entry.count++;
+    entry.nanoseconds += std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count();
+    entry.late[bucket]++;
+}
+
+#endif
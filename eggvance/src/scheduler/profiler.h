@@ -0,0 +1,36 @@
+#pragma once
+
+#ifdef EGGVANCE_PROFILE
+
+#include <chrono>
+#include <map>
+#include <string_view>
+#include <shell/array.h>
+
+#include "event.h"
+
+class Profiler
+{
+public:
+    ~Profiler();
+
+    void run(Event& event, u64 late);
+
+private:
+    using Clock = std::chrono::high_resolution_clock;
+
+    static constexpr uint kBuckets = 16;
+
+    struct Stats
+    {
+        u64 count = 0;
+        u64 nanoseconds = 0;
+        shell::array<u64, kBuckets> late = {};
+    };
+
+    std::map<std::string_view, Stats> stats;
+};
+
+inline Profiler profiler;
+
+#endif
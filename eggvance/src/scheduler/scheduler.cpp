@@ -2,38 +2,46 @@
 
 #include <limits>
 
+#include "profiler.h"
+
 Scheduler::Scheduler()
 {
-    next = std::numeric_limits<u64>::max();
-
-    infinity.when = next;
-    infinity = [](u64 late) { SHELL_UNREACHABLE; };
-
-    list.setHead(infinity);
+    update();
 }
 
-void Scheduler::run(u64 cycles)
+void Scheduler::process()
 {
-    now += cycles;
-
     while (now >= next)
     {
-        Event& event = list.pop();
+        Event& event = heap.pop();
         event.when = 0;
-        event.callback(now - next);
 
-        next = list.head->when;
+        #ifdef EGGVANCE_PROFILE
+        profiler.run(event, now - next);
+        #else
+        event(now - next);
+        #endif
+
+        update();
     }
 }
 
+void Scheduler::update()
+{
+    next = heap.empty()
+        ? std::numeric_limits<u64>::max()
+        : heap.top().when;
+}
+
 void Scheduler::insert(Event& event, u64 in)
 {
     SHELL_ASSERT(event.when == 0);
     SHELL_ASSERT(static_cast<s64>(in) > 0);
 
-    event.when = now + in;
-    list.insert(event);
-    next = list.head->when;
+    event.when  = now + in;
+    event.order = order++;
+    heap.insert(event);
+    update();
 }
 
 void Scheduler::remove(Event& event)
@@ -41,7 +49,7 @@ void Scheduler::remove(Event& event)
     if (event.when)
     {
         event.when = 0;
-        list.remove(event);
-        next = list.head->when;
+        heap.remove(event);
+        update();
     }
 }
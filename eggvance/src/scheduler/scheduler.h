@@ -1,14 +1,23 @@
 #pragma once
 
-#include "circularlist.h"
+#include <shell/macros.h>
+
 #include "event.h"
+#include "minheap.h"
 
 class Scheduler
 {
 public:
     Scheduler();
 
-    void run(u64 cycles);
+    SHELL_INLINE void run(u64 cycles)
+    {
+        now += cycles;
+
+        if (now >= next)
+            process();
+    }
+
     void insert(Event& event, u64 in);
     void remove(Event& event);
 
@@ -16,8 +25,13 @@ class Scheduler
     u64 next = 0;
 
 private:
-    Event infinity;
-    CircularList<Event> list;
+    static constexpr uint kEvents = 32;
+
+    void process();
+    void update();
+
+    u64 order = 0;
+    MinHeap<Event, kEvents> heap;
 };
 
 inline Scheduler scheduler;
@@ -20,7 +20,11 @@ u8 TimerCount::read(uint index)
 
 void TimerCount::write(uint index, u8 byte)
 {
+    channel.sync();
+
     bit::byteRef(initial, index) = byte;
+
+    channel.schedule();
 }
 
 TimerControl::TimerControl(TimerChannel& channel)
@@ -38,8 +42,11 @@ void TimerControl::write(uint index, u8 byte)
 
     Register::write(index, byte);
 
-    if (runnable())
-        channel.run();
+    channel.sync();
+
+    // The previous channel batches overflows unless this one cascades
+    if (channel.prev)
+        channel.prev->sync();
 
     uint was_enabled = enabled;
 
@@ -52,6 +59,9 @@ void TimerControl::write(uint index, u8 byte)
         channel.start();
     else
         channel.update();
+
+    if (channel.prev)
+        channel.prev->schedule();
 }
 
 bool TimerControl::runnable() const
@@ -53,24 +53,34 @@ void TimerChannel::run(u64 ticks)
 
     counter += ticks;
     
-    if (counter >= overflow)
+    if (counter < overflow)
     {
-        if (control.irq)
-            arm.raise(Irq::Timer << id, counter - overflow);
+        count.counter = counter / control.prescaler + initial;
+        since = scheduler.now;
+        return;
+    }
 
-        if (next && next->control.cascade)
-            next->run(counter / overflow);
+    u64 late = counter - overflow;
 
-        if (id <= 1)
-            apu.onOverflow(id, counter / overflow);
+    // Periods after the first one reload from the current initial value
+    counter -= overflow;
+    initial  = count.initial;
+    overflow = control.prescaler * (kOverflow - initial);
 
-        counter %= overflow;
-        initial  = count.initial;
-        overflow = control.prescaler * (kOverflow - initial);
-    }
+    u64 overflows = 1 + counter / overflow;
 
+    counter %= overflow;
     count.counter = counter / control.prescaler + initial;
     since = scheduler.now;
+
+    if (control.irq)
+        arm.raise(Irq::Timer << id, late);
+
+    if (next && next->control.cascade)
+        next->run(overflows);
+
+    if (id <= 1)
+        apu.onOverflow(id, overflows);
 }
 
 void TimerChannel::run()
@@ -78,12 +88,32 @@ void TimerChannel::run()
     run(scheduler.now - since);
 }
 
+void TimerChannel::sync()
+{
+    if (control.runnable())
+        run();
+}
+
 void TimerChannel::schedule()
 {
     scheduler.remove(events.run);
 
     if (!control.runnable() || events.start.isScheduled())
         return;
-    
-    scheduler.insert(events.run, overflow - counter);
+
+    u64 overflows = pendingOverflows();
+    if (overflows == 0)
+        return;
+
+    u64 period = control.prescaler * (kOverflow - count.initial);
+
+    scheduler.insert(events.run, overflow - counter + (overflows - 1) * period);
+}
+
+u64 TimerChannel::pendingOverflows() const
+{
+    if (control.irq || (next && next->control.cascade))
+        return 1;
+
+    return id <= 1 ? apu.pendingOverflows(id) : 0;
 }
@@ -11,20 +11,23 @@ class TimerChannel
     void start();
     void update();
     void schedule();
+    void sync();
     void run();
 
     const uint id;
     TimerCount count;
     TimerControl control;
+    TimerChannel* prev = nullptr;
     TimerChannel* next = nullptr;
 
 private:
     void run(u64 ticks);
+    u64 pendingOverflows() const;
 
     struct Events
     {
-        Event run;
-        Event start;
+        Event run{"timer.run"};
+        Event start{"timer.start"};
     } events;
 
     u64 since    = 0;